@@ -17,6 +17,8 @@
 #include <ctype.h>
 #include <errno.h>
 
+#define CLIENT_MAX_PAYLOAD (64 * 1024) // messaggio piu' lungo accettato dal server (classifica, bacheca)
+
 void client_run(int sockfd);
 
 #endif // CLIENT_H
@@ -73,6 +73,10 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
+    // comandi brevi: inviati subito, senza attendere l'ACK del segmento precedente
+    if (set_tcp_nodelay(sockfd) < 0)
+        perror("setsockopt TCP_NODELAY");
+
     printf("[CLIENT MAIN] Connesso a %s sulla porta %d\n", server_name, port);
 
     // avvio client logic
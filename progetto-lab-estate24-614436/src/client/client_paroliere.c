@@ -87,7 +87,7 @@ bool valida_nome_utente(const char *nome, int nome_len)
 /*
     client_thread:
         thread dedicato alla ricezione continua dei messaggi del server
-         - legge i messaggi usando receive_message
+         - legge i messaggi con un msg_reader (piu' messaggi per read)
          - li interpreta e li stampa
          - in caso di erroe o di messaggio di shutdown, shutdown_flag = 1
 
@@ -99,14 +99,24 @@ void *client_receiver(void *arg)
 {
     int sockfd = *(int *)arg;
     char type;
-    char data[BUFFER_SIZE];
+    char *data;
     unsigned int length;
 
+    msg_reader reader;
+    if (msg_reader_init(&reader, sockfd, CLIENT_MAX_PAYLOAD) < 0)
+    {
+        fprintf(stderr, "\n[CLIENT] Memoria esaurita\n");
+        shutdown_flag = 1;
+        return NULL;
+    }
+
     while (!shutdown_flag)
     {
         // Se la ricezione fallisce, cerchiamo di capire se è timeout o errore di connessione
-        if (receive_message(sockfd, &type, data, &length) < 0)
+        if (msg_reader_receive(&reader, &type, &data, &length) < 0)
         {
+            if (errno == EINTR)
+                continue;
             // errore EAGAIN / EWOULDBLOCK, read su socket scaduta per timeout
             if (errno == EAGAIN || errno == EWOULDBLOCK)
             {
@@ -157,20 +167,26 @@ void *client_receiver(void *arg)
                 token_count++;
                 tok = strtok(NULL, " ");
             }
-            // Se sono esattamente 16, assumiamo che si tratti della matrice e stampiamo la griglia
-            if (token_count == 16)
+            // Se sono 16, 25 o 36 (griglia 4x4, 5x5 o 6x6), assumiamo che si tratti della matrice e stampiamo la griglia
+            int dim = 0;
+            for (int d = 4; d <= 6; d++)
+            {
+                if (token_count == d * d)
+                    dim = d;
+            }
+            if (dim > 0)
             {
                 char matrix_copy[BUFFER_SIZE];
                 strncpy(matrix_copy, data, BUFFER_SIZE);
                 matrix_copy[BUFFER_SIZE - 1] = '\0';
                 char *token = strtok(matrix_copy, " ");
-                for (int row = 0; row < 4; row++)
+                for (int row = 0; row < dim; row++)
                 {
-                    for (int col = 0; col < 4; col++)
+                    for (int col = 0; col < dim; col++)
                     {
                         if (token != NULL)
                         {
-                            printf("%s ", token);
+                            printf("%-3s", token);
                             token = strtok(NULL, " ");
                         }
                     }
@@ -191,6 +207,33 @@ void *client_receiver(void *arg)
         case MSG_PUNTI_PAROLA:
             printf("\n[SERVER] PUNTI PAROLA: %s\n", data);
             break;
+        case MSG_CLASSIFICA_LIVE:
+            // primi giocatori della partita in corso, una riga "posizione nome punti"
+            printf("\n[SERVER] CLASSIFICA PARZIALE:\n%s", data);
+            break;
+        case MSG_PUNTI_PAROLE:
+        {
+            // una riga "parola esito" per ogni parola inviata con pp
+            printf("\n[SERVER] PUNTI PAROLE:\n");
+            char *saveptr;
+            for (char *line = strtok_r(data, "\n", &saveptr); line; line = strtok_r(NULL, "\n", &saveptr))
+            {
+                char *sep = strrchr(line, ' ');
+                if (!sep)
+                    continue;
+                *sep = '\0';
+                int esito = atoi(sep + 1);
+                if (esito == ESITO_NON_IN_MATRICE)
+                    printf("  %s: non presente in matrice\n", line);
+                else if (esito == ESITO_NON_IN_DIZIONARIO)
+                    printf("  %s: non presente in dizionario\n", line);
+                else if (esito == 0)
+                    printf("  %s: gia' proposta, 0 punti\n", line);
+                else
+                    printf("  %s: %d punti\n", line, esito);
+            }
+            break;
+        }
         case MSG_SHOW_BACHECA:
             printf("\n[SERVER] BACHECA:\n%s\n", data);
             break;
@@ -202,6 +245,7 @@ void *client_receiver(void *arg)
         fflush(stdout);
         pthread_mutex_unlock(&client_console_mutex);
     }
+    msg_reader_free(&reader);
     return NULL;
 }
 
@@ -219,6 +263,7 @@ void print_help()
     printf("  cancella_registrazione        - Cancella la registrazione\n");
     printf("  matrice                       - Richiede la matrice corrente\n");
     printf("  p <parola>                    - Invia una parola per verifica e punteggio\n");
+    printf("  pp <parola> <parola> ...      - Invia piu' parole in un solo messaggio\n");
     printf("  msg <testo_messaggio>         - Posta un messaggio sulla bacheca (max 128 caratteri)\n");
     printf("  show-msg                      - Visualizza il contenuto della bacheca\n");
     printf("  fine                          - Termina la sessione\n");
@@ -372,6 +417,20 @@ void client_run(int sockfd)
             normalize_word(parametro, param_len);
             send_message(sockfd, MSG_PAROLA, parametro, param_len + 1);
         }
+        // PIU' PAROLE
+        else if (strcmp(comando, "pp") == 0)
+        {
+            if (parametro == NULL)
+            {
+                printf("Specifica almeno una parola.\n");
+                continue;
+            }
+            while (*parametro == ' ')
+                parametro++;
+            // normalize_word agisce carattere per carattere: gli spazi tra le parole restano
+            normalize_word(parametro, -1);
+            send_message(sockfd, MSG_PAROLE, parametro, strlen(parametro) + 1);
+        }
         // AIUTO
         else if (strcmp(comando, "aiuto") == 0)
         {
@@ -1,5 +1,7 @@
 #include "common.h"
 
+#include <netinet/tcp.h>
+
 // ======================= Funzioni di comunicazione =======================
 
 /*
@@ -33,6 +35,43 @@ ssize_t robust_write(int fd, const void *buf, size_t count)
     return total_written;
 }
 
+/*
+    robust_writev:
+        scrive tutti i buffer di iov con writev, ripetendo in caso di interruzioni
+        e riprendendo dal punto raggiunto dopo una scrittura parziale
+*/
+ssize_t robust_writev(int fd, struct iovec *iov, int iovcnt)
+{
+    size_t total_written = 0;
+    while (iovcnt > 0)
+    {
+        ssize_t written = writev(fd, iov, iovcnt);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue; // riprova
+            fprintf(stderr, "robust_writev error: %s\n", strerror(errno));
+            return -1;
+        }
+        total_written += written;
+
+        // salta i buffer scritti per intero, accorcia quello scritto in parte
+        size_t n = (size_t)written;
+        while (iovcnt > 0 && n >= iov->iov_len)
+        {
+            n -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return total_written;
+}
+
 /*
     robust_read:
         legge 'count' byte dal descrittore fd, ripetendo caso di interrupt
@@ -67,64 +106,192 @@ ssize_t robust_read(int fd, void *buf, size_t count)
 */
 int send_message(int sockfd, char type, const char *data, unsigned int length)
 {
-    // conversione in network length
-    unsigned int netlen = htonl(length);
-    if (robust_write(sockfd, &type, 1) != 1)
+    // intestazione e dati con una sola writev: una system call invece di tre
+    msg_batch batch;
+    msg_batch_init(&batch);
+    msg_batch_add(&batch, type, data, length);
+    if (msg_batch_send(sockfd, &batch) < 0)
     {
-        perror("robust_write(type)");
+        perror("robust_writev(message)");
         return -1;
     }
+    return 0;
+}
 
-    if (robust_write(sockfd, &netlen, 4) != 4)
-    {
-        perror("robust_write(netlen)");
+/*
+    set_tcp_nodelay:
+        disabilita l'algoritmo di Nagle sul socket
+*/
+int set_tcp_nodelay(int sockfd)
+{
+    int on = 1;
+    return setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+// ======================= Invio di piu' messaggi =======================
+
+void msg_batch_init(msg_batch *batch)
+{
+    batch->msg_count = 0;
+    batch->iov_count = 0;
+    batch->size = 0;
+}
+
+int msg_batch_add(msg_batch *batch, char type, const char *data, unsigned int length)
+{
+    if (batch->msg_count == MSG_BATCH_MAX)
         return -1;
-    }
-    if (length > 0 && robust_write(sockfd, data, length) != length)
+
+    // conversione in network length
+    char *header = batch->headers[batch->msg_count++];
+    unsigned int netlen = htonl(length);
+    header[0] = type;
+    memcpy(header + 1, &netlen, 4);
+
+    batch->iov[batch->iov_count].iov_base = header;
+    batch->iov[batch->iov_count].iov_len = MSG_HEADER_SIZE;
+    batch->iov_count++;
+    if (length > 0)
     {
-        return -1;
+        batch->iov[batch->iov_count].iov_base = (void *)data;
+        batch->iov[batch->iov_count].iov_len = length;
+        batch->iov_count++;
     }
+    batch->size += MSG_HEADER_SIZE + length;
     return 0;
 }
 
-/*
-    receive_message:
-    riceve un messaggio dal client:
-        [1 byte type] [4 byte lunghezza (network order)] [data]
-    popola i parametri in output cone le informazioni ricevute.
-    ritorna 0 in caso di successo e -1 in caso di fine connessione/errore
-*/
-int receive_message(int sockfd, char *type, char *data, unsigned int *length)
+int msg_batch_add_raw(msg_batch *batch, const void *bytes, size_t size)
 {
-    ssize_t n = robust_read(sockfd, type, 1);
-    if (n <= 0)
-    {
-        if (n < 0 && (errno != EAGAIN && errno != EINTR))
-        {
-            perror("robust_read(type)");
-        }
+    if (batch->msg_count == MSG_BATCH_MAX)
         return -1;
+    batch->msg_count++;
+    batch->iov[batch->iov_count].iov_base = (void *)bytes;
+    batch->iov[batch->iov_count].iov_len = size;
+    batch->iov_count++;
+    batch->size += size;
+    return 0;
+}
+
+int msg_batch_send(int sockfd, msg_batch *batch)
+{
+    ssize_t written = batch->iov_count > 0 ? robust_writev(sockfd, batch->iov, batch->iov_count) : 0;
+    size_t expected = batch->size;
+    msg_batch_init(batch);
+    return written == (ssize_t)expected ? 0 : -1;
+}
+
+// ======================= Ricezione bufferizzata =======================
+
+int msg_reader_init(msg_reader *reader, int fd, unsigned int max_payload)
+{
+    size_t capacity = MSG_HEADER_SIZE + (size_t)max_payload;
+    if (capacity < MSG_READER_MIN_CAPACITY)
+        capacity = MSG_READER_MIN_CAPACITY;
+
+    reader->buf = malloc(capacity + 1);
+    if (!reader->buf)
+        return -1;
+    reader->capacity = capacity;
+    reader->max_payload = max_payload;
+    msg_reader_reset(reader, fd);
+    return 0;
+}
+
+void msg_reader_reset(msg_reader *reader, int fd)
+{
+    reader->fd = fd;
+    reader->start = 0;
+    reader->end = 0;
+    reader->lent = false;
+}
+
+void msg_reader_free(msg_reader *reader)
+{
+    free(reader->buf);
+    reader->buf = NULL;
+}
+
+// ripristina il byte sostituito dal terminatore dell'ultimo frame restituito
+static void msg_reader_restore(msg_reader *reader)
+{
+    if (reader->lent)
+    {
+        reader->buf[reader->start] = reader->lent_byte;
+        reader->lent = false;
     }
+}
 
-    unsigned int netlen;
-    n = robust_read(sockfd, &netlen, 4);
-    if (n <= 0)
+ssize_t msg_reader_fill(msg_reader *reader)
+{
+    msg_reader_restore(reader);
+
+    // sposta in testa l'eventuale frame incompleto: dopo l'estrazione restano pochi byte,
+    // e un frame di dimensione massima entra sempre in un buffer vuoto
+    if (reader->start > 0)
     {
-        if (n < 0 && (errno != EAGAIN && errno != EINTR))
-        {
-            perror("robust_read(netlen)");
-        }
-        return -1;
+        memmove(reader->buf, reader->buf + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
     }
 
+    // EINTR non viene ripetuta: il chiamante puo' reagire al segnale (es. SIGINT del server,
+    // installato senza SA_RESTART: il thread del client ricontrolla il flag di stop)
+    ssize_t n = read(reader->fd, reader->buf + reader->end, reader->capacity - reader->end);
+    if (n > 0)
+        reader->end += n;
+    return n;
+}
+
+int msg_reader_next(msg_reader *reader, char *type, char **data, unsigned int *length)
+{
+    msg_reader_restore(reader);
+
+    size_t available = reader->end - reader->start;
+    if (available < MSG_HEADER_SIZE)
+        return 0;
+
     // conversione da network length
-    *length = ntohl(netlen);
-    if (*length > 0)
+    unsigned int netlen;
+    memcpy(&netlen, reader->buf + reader->start + 1, 4);
+    unsigned int len = ntohl(netlen);
+    if (len > reader->max_payload)
+        return -1;
+    if (available < MSG_HEADER_SIZE + (size_t)len)
+        return 0;
+
+    *type = reader->buf[reader->start];
+    *data = reader->buf + reader->start + MSG_HEADER_SIZE;
+    *length = len;
+    reader->start += MSG_HEADER_SIZE + len;
+
+    // terminatore al posto del primo byte del frame successivo (buf ha un byte di margine)
+    reader->lent_byte = reader->buf[reader->start];
+    reader->buf[reader->start] = '\0';
+    reader->lent = true;
+    return 1;
+}
+
+int msg_reader_receive(msg_reader *reader, char *type, char **data, unsigned int *length)
+{
+    for (;;)
     {
-        if (robust_read(sockfd, data, *length) != *length)
+        int ret = msg_reader_next(reader, type, data, length);
+        if (ret > 0)
+            return 0;
+        if (ret < 0)
         {
+            errno = EMSGSIZE;
             return -1;
         }
+
+        ssize_t n = msg_reader_fill(reader);
+        if (n == 0)
+        {
+            errno = ENOTCONN; // fine connessione
+            return -1;
+        }
+        if (n < 0)
+            return -1;
     }
-    return 0;
-}
\ No newline at end of file
+}
@@ -15,8 +15,14 @@
 #include <errno.h>
 #include <ctype.h>
 #include <string.h>
+#include <stdbool.h>
+#include <sys/uio.h>
 
 #define BUFFER_SIZE 512
+#define MSG_HEADER_SIZE 5 // [1 byte type] [4 byte lunghezza]
+#define MSG_BATCH_MAX 8   // messaggi accodabili in un msg_batch
+#define MSG_READER_MIN_CAPACITY 4096 // buffer minimo di un msg_reader (piu' frame brevi per read)
+#define MSG_PAROLE_MAX 8192 // payload massimo di MSG_PAROLE (terminatore compreso), il frame piu' lungo che un client puo' inviare
 
 #define MSG_OK 'K'
 #define MSG_ERR 'E'
@@ -32,6 +38,14 @@
 #define MSG_TEMPO_ATTESA 'A'
 #define MSG_POST_BACHECA 'H'
 #define MSG_SHOW_BACHECA 'S'
+#define MSG_PAROLE 'V'       // piu' parole in un messaggio, separate da spazi, al piu' MSG_PAROLE_MAX byte:
+                             // un frame piu' lungo riceve MSG_ERR e chiude la connessione
+#define MSG_PUNTI_PAROLE 'Q' // esiti di MSG_PAROLE, una riga "parola esito" per parola
+#define MSG_CLASSIFICA_LIVE 'C' // classifica parziale durante la partita, una riga "posizione nome punti"
+
+// esiti negativi di una parola in MSG_PUNTI_PAROLE (esito >= 0: punti assegnati, 0 se gia' proposta)
+#define ESITO_NON_IN_MATRICE -1
+#define ESITO_NON_IN_DIZIONARIO -2
 
 // ======================= Funzioni di comunicazione =======================
 /*
@@ -40,6 +54,16 @@
 */
 ssize_t robust_write(int fd, const void *buf, size_t count);
 
+/*
+    robust_writev:
+        scrive tutti i buffer di iov con writev, ripetendo in caso di interruzioni
+        e riprendendo dal punto raggiunto dopo una scrittura parziale.
+        restituisce il numero di byte scritti oppure -1 in caso di errore.
+    si assume che:
+        - iov sia modificabile: dopo la chiamata il suo contenuto non e' specificato
+*/
+ssize_t robust_writev(int fd, struct iovec *iov, int iovcnt);
+
 /*
     robust_read:
         legge 'count' byte dal descrittore fd, ripetendo caso di interrupt
@@ -55,12 +79,123 @@ ssize_t robust_read(int fd, void *buf, size_t count);
 int send_message(int sockfd, char type, const char *data, unsigned int length);
 
 /*
-    receive_message:
-    riceve un messaggio dal client:
-        [1 byte type] [4 byte lunghezza (network order)] [data]
-    popola i parametri in output cone le informazioni ricevute.
-    ritorna 0 in caso di successo e -1 in caso di fine connessione/errore
+    set_tcp_nodelay:
+        disabilita l'algoritmo di Nagle sul socket: i messaggi brevi (risposte, comandi)
+        partono subito invece di attendere l'ACK del segmento precedente.
+        restituisce 0 in caso di successo, -1 in caso di errore
+*/
+int set_tcp_nodelay(int sockfd);
+
+// ======================= Invio di piu' messaggi =======================
+/*
+    msg_batch:
+        raccoglie fino a MSG_BATCH_MAX messaggi destinati allo stesso socket,
+        inviati poi con una sola writev (una system call, un segmento TCP se piccoli).
+        i dati dei messaggi non vengono copiati: devono restare validi fino all'invio.
+*/
+typedef struct
+{
+    char headers[MSG_BATCH_MAX][MSG_HEADER_SIZE];
+    struct iovec iov[2 * MSG_BATCH_MAX];
+    int msg_count;
+    int iov_count;
+    size_t size; // byte totali accodati
+} msg_batch;
+
+/*
+    msg_batch_init:
+        prepara un batch vuoto
+*/
+void msg_batch_init(msg_batch *batch);
+
+/*
+    msg_batch_add:
+        accoda un messaggio [type][lunghezza][data] al batch.
+        restituisce 0 in caso di successo, -1 se il batch e' pieno
+*/
+int msg_batch_add(msg_batch *batch, char type, const char *data, unsigned int length);
+
+/*
+    msg_batch_add_raw:
+        accoda byte gia' serializzati secondo il protocollo (uno o piu' messaggi completi).
+        restituisce 0 in caso di successo, -1 se il batch e' pieno
+*/
+int msg_batch_add_raw(msg_batch *batch, const void *bytes, size_t size);
+
+/*
+    msg_batch_send:
+        invia tutti i messaggi del batch con writev e lo svuota.
+        restituisce 0 in caso di successo, -1 per errore
+*/
+int msg_batch_send(int sockfd, msg_batch *batch);
+
+// ======================= Ricezione bufferizzata =======================
+/*
+    msg_reader:
+        lettore di messaggi per una connessione: ogni read preleva tutti i byte
+        disponibili (fino alla capacita' del buffer), da cui vengono poi estratti
+        uno o piu' frame senza altre system call. un frame il cui payload supera
+        max_payload e' un errore di protocollo.
+        i frame estratti sono restituiti come vista sul buffer (nessuna copia),
+        terminata da '\0': il byte successivo al payload viene sostituito
+        temporaneamente e ripristinato alla chiamata successiva.
+*/
+typedef struct
+{
+    int fd;
+    char *buf;
+    size_t capacity;          // byte utilizzabili (buf ne ha uno in piu' per il terminatore)
+    size_t start;             // primo byte non ancora consumato
+    size_t end;               // fine dei byte letti
+    unsigned int max_payload; // payload massimo accettato
+    bool lent;                // true se buf[start] e' stato sostituito da '\0'
+    char lent_byte;           // valore originale di buf[start]
+} msg_reader;
+
+/*
+    msg_reader_init:
+        alloca il buffer del lettore per il descrittore fd (anche -1, da impostare con msg_reader_reset).
+        restituisce 0 in caso di successo, -1 se la memoria e' esaurita
+*/
+int msg_reader_init(msg_reader *reader, int fd, unsigned int max_payload);
+
+/*
+    msg_reader_reset:
+        scarta i dati bufferizzati e associa il lettore a un nuovo descrittore
+*/
+void msg_reader_reset(msg_reader *reader, int fd);
+
+/*
+    msg_reader_free:
+        libera il buffer del lettore
+*/
+void msg_reader_free(msg_reader *reader);
+
+/*
+    msg_reader_fill:
+        esegue una sola read con tutto lo spazio libero del buffer.
+        restituisce i byte letti, 0 a fine connessione, -1 in caso di errore (errno impostato,
+        EAGAIN/EWOULDBLOCK per un socket non bloccante senza dati o per un timeout di ricezione)
+*/
+ssize_t msg_reader_fill(msg_reader *reader);
+
+/*
+    msg_reader_next:
+        estrae il prossimo frame completo gia' presente nel buffer, senza system call.
+        restituisce 1 se un frame e' disponibile, 0 se servono altri dati, -1 se il frame
+        annunciato supera max_payload.
+        *data punta al payload (terminato da '\0') e resta valido fino alla prossima
+        chiamata sul lettore
+*/
+int msg_reader_next(msg_reader *reader, char *type, char **data, unsigned int *length);
+
+/*
+    msg_reader_receive:
+        come msg_reader_next, ma attende (read bloccanti) finche' un frame non e' completo.
+        ritorna 0 in caso di successo e -1 in caso di fine connessione/errore/frame troppo lungo
+        (errno EMSGSIZE); un'interruzione da segnale restituisce -1 con errno EINTR
+        e i byte gia' ricevuti restano nel buffer
 */
-int receive_message(int sockfd, char *type, char *data, unsigned int *length);
+int msg_reader_receive(msg_reader *reader, char *type, char **data, unsigned int *length);
 
 #endif // COMMON_H
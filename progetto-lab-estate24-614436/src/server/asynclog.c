@@ -0,0 +1,485 @@
+#define _GNU_SOURCE
+
+#include "asynclog.h"
+#include "eventlog.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+
+// ======================= ring per thread =======================
+
+// tipi di record: ognuno e' scritto in un file diverso
+#define LOG_KIND_TEXT 0    // messaggio di testo (asynclog_vwrite)
+#define LOG_KIND_EVENT 1   // record binario del log degli eventi (asynclog_event)
+#define LOG_KIND_CONSOLE 2 // messaggio per stdout (asynclog_console)
+#define LOG_KINDS 3
+
+// intestazione di un record nel ring, seguita da 'len' byte di testo o del record binario
+typedef struct
+{
+    int64_t time; // secondi (time(NULL)) al momento della chiamata
+    uint32_t len;
+    uint32_t kind; // LOG_KIND_*
+} log_header;
+
+// file di destinazione di un tipo di record
+typedef struct
+{
+    int fd;     // -1 se il file non e' aperto
+    char *path; // NULL per stdout (nessuna rotazione)
+    off_t file_size;
+} log_sink;
+
+// ring di un thread: allocati una volta e mai liberati, riusati quando il thread termina
+typedef struct log_ring
+{
+    char *buf;
+    uint32_t head;         // byte scritti (solo il produttore)
+    uint32_t tail;         // byte letti (solo il writer)
+    unsigned long dropped; // record scartati per ring pieno
+    bool in_use;
+    struct log_ring *next;
+} log_ring;
+
+static struct
+{
+    log_ring *rings; // solo inserimenti in testa
+    pthread_mutex_t rings_mutex;
+    pthread_key_t key;
+    pthread_once_t once;
+
+    bool running;
+    bool stop;
+    int sleeping; // il writer sta per dormire sull'eventfd
+    int wake_fd;
+    pthread_t writer;
+
+    log_sink sinks[LOG_KINDS];
+    bool events; // log degli eventi aperto (fissato prima di avviare il writer)
+    char name[128];
+    unsigned long dropped_reported;
+} g_log = {.rings_mutex = PTHREAD_MUTEX_INITIALIZER, .once = PTHREAD_ONCE_INIT, .wake_fd = -1, .sinks = {{.fd = -1}, {.fd = -1}, {.fd = -1}}};
+
+static void ring_release(void *arg)
+{
+    log_ring *r = arg;
+    pthread_mutex_lock(&g_log.rings_mutex);
+    r->in_use = false;
+    pthread_mutex_unlock(&g_log.rings_mutex);
+}
+
+static void key_init()
+{
+    pthread_key_create(&g_log.key, ring_release);
+}
+
+// ring del thread chiamante, assegnato al primo utilizzo (NULL se la memoria e' esaurita)
+static log_ring *ring_self()
+{
+    pthread_once(&g_log.once, key_init);
+    log_ring *r = pthread_getspecific(g_log.key);
+    if (r)
+        return r;
+
+    pthread_mutex_lock(&g_log.rings_mutex);
+    for (r = g_log.rings; r; r = r->next)
+    {
+        if (!r->in_use)
+            break;
+    }
+    if (!r)
+    {
+        r = calloc(1, sizeof(log_ring));
+        if (r)
+            r->buf = malloc(LOG_RING_SIZE);
+        if (!r || !r->buf)
+        {
+            free(r);
+            pthread_mutex_unlock(&g_log.rings_mutex);
+            return NULL;
+        }
+        r->next = g_log.rings;
+        __atomic_store_n(&g_log.rings, r, __ATOMIC_RELEASE);
+    }
+    r->in_use = true;
+    pthread_mutex_unlock(&g_log.rings_mutex);
+
+    pthread_setspecific(g_log.key, r);
+    return r;
+}
+
+// copia n byte nel ring a partire dalla posizione pos (modulo LOG_RING_SIZE)
+static void ring_put(log_ring *r, uint32_t pos, const void *src, uint32_t n)
+{
+    uint32_t off = pos & (LOG_RING_SIZE - 1);
+    uint32_t first = n < LOG_RING_SIZE - off ? n : LOG_RING_SIZE - off;
+    memcpy(r->buf + off, src, first);
+    memcpy(r->buf, (const char *)src + first, n - first);
+}
+
+static void ring_get(const log_ring *r, uint32_t pos, void *dst, uint32_t n)
+{
+    uint32_t off = pos & (LOG_RING_SIZE - 1);
+    uint32_t first = n < LOG_RING_SIZE - off ? n : LOG_RING_SIZE - off;
+    memcpy(dst, r->buf + off, first);
+    memcpy((char *)dst + first, r->buf, n - first);
+}
+
+// ======================= produttori =======================
+
+// risveglia il writer se sta dormendo (una sola write sull'eventfd per risveglio)
+static void writer_wake()
+{
+    if (__atomic_load_n(&g_log.sleeping, __ATOMIC_SEQ_CST) && __atomic_exchange_n(&g_log.sleeping, 0, __ATOMIC_SEQ_CST))
+    {
+        uint64_t one = 1;
+        if (write(g_log.wake_fd, &one, sizeof(one)) < 0)
+        {
+            // il writer si risveglia comunque allo shutdown
+        }
+    }
+}
+
+/*
+    ring_begin:
+        ring del thread chiamante su cui accodare un record, NULL se il log non e' aperto
+        o se la memoria e' esaurita. alla prima chiamata di un thread prende rings_mutex
+        e alloca il ring: per questo il log non si puo' usare da un signal handler
+*/
+static log_ring *ring_begin()
+{
+    if (!__atomic_load_n(&g_log.running, __ATOMIC_ACQUIRE))
+        return NULL;
+    return ring_self();
+}
+
+// accoda il record nel ring ottenuto da ring_begin (o lo scarta se il ring resta pieno)
+static void ring_push(log_ring *r, uint32_t kind, const void *data, uint32_t len)
+{
+    log_header h = {.time = time(NULL), .len = len, .kind = kind};
+    uint32_t size = sizeof(h) + h.len;
+    uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    // ring pieno: si cede il processore al writer per qualche giro prima di scartare il record
+    for (int retry = 0; LOG_RING_SIZE - (r->head - tail) < size && retry < LOG_FULL_RETRIES; retry++)
+    {
+        writer_wake();
+        sched_yield();
+        tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    }
+    if (LOG_RING_SIZE - (r->head - tail) < size)
+    {
+        __atomic_add_fetch(&r->dropped, 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        ring_put(r, r->head, &h, sizeof(h));
+        ring_put(r, r->head + sizeof(h), data, h.len);
+        // pubblica il record; SEQ_CST: la lettura di 'sleeping' non puo' precedere la pubblicazione
+        __atomic_store_n(&r->head, r->head + size, __ATOMIC_SEQ_CST);
+        writer_wake();
+    }
+}
+
+// formatta il messaggio e lo accoda come record di tipo 'kind'
+static void ring_push_text(log_ring *r, uint32_t kind, const char *format, va_list args)
+{
+    char text[LOG_LINE_MAX];
+    int n = vsnprintf(text, sizeof(text), format, args);
+    if (n < 0)
+        n = 0;
+    if (n >= (int)sizeof(text))
+        n = sizeof(text) - 1;
+    ring_push(r, kind, text, (uint32_t)n);
+}
+
+void asynclog_vwrite(const char *format, va_list args)
+{
+    log_ring *r = ring_begin();
+    if (r)
+        ring_push_text(r, LOG_KIND_TEXT, format, args);
+}
+
+bool asynclog_console(const char *format, va_list args)
+{
+    if (!__atomic_load_n(&g_log.running, __ATOMIC_ACQUIRE))
+        return false;
+    log_ring *r = ring_begin();
+    if (r)
+        ring_push_text(r, LOG_KIND_CONSOLE, format, args);
+    return true;
+}
+
+void asynclog_event(const void *record, size_t len)
+{
+    if (!g_log.events)
+        return;
+    log_ring *r = ring_begin();
+    if (r)
+        ring_push(r, LOG_KIND_EVENT, record, (uint32_t)len);
+}
+
+// ======================= writer =======================
+
+// blocco di scrittura di ogni file
+static struct
+{
+    char data[LOG_BATCH_SIZE];
+    size_t used;
+} g_batch[LOG_KINDS];
+
+static void batch_flush(int kind)
+{
+    log_sink *s = &g_log.sinks[kind];
+    size_t off = 0;
+    while (s->fd >= 0 && off < g_batch[kind].used)
+    {
+        ssize_t n = write(s->fd, g_batch[kind].data + off, g_batch[kind].used - off);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break; // errore di scrittura: il blocco viene perso
+        }
+        off += n;
+    }
+    s->file_size += off;
+    g_batch[kind].used = 0;
+}
+
+static void batch_line(int kind, const void *line, size_t len);
+
+/*
+    sink_open:
+        apre (in append) il file del tipo di record 'kind'; un log degli eventi vuoto
+        comincia con l'intestazione del formato. restituisce -1 in caso di errore
+*/
+static int sink_open(int kind)
+{
+    log_sink *s = &g_log.sinks[kind];
+    s->fd = open(s->path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (s->fd < 0)
+        return -1;
+    struct stat st;
+    s->file_size = fstat(s->fd, &st) == 0 ? st.st_size : 0;
+    if (kind == LOG_KIND_EVENT && s->file_size == 0)
+    {
+        event_file_header h = {.magic = EVENT_MAGIC, .byte_order = EVENT_BYTE_ORDER, .header_size = sizeof(event_header)};
+        batch_line(kind, &h, sizeof(h));
+    }
+    return 0;
+}
+
+/*
+    sink_rotate:
+        rinomina path.i in path.i+1 (l'ultimo viene sovrascritto), path in path.1
+        e riapre un file vuoto
+*/
+static void sink_rotate(int kind)
+{
+    log_sink *s = &g_log.sinks[kind];
+    size_t len = strlen(s->path) + 16;
+    char from[len], to[len];
+    for (int i = LOG_ROTATE_KEEP - 1; i >= 1; i--)
+    {
+        snprintf(from, len, "%s.%d", s->path, i);
+        snprintf(to, len, "%s.%d", s->path, i + 1);
+        rename(from, to);
+    }
+    snprintf(to, len, "%s.1", s->path);
+    close(s->fd);
+    rename(s->path, to);
+    sink_open(kind);
+}
+
+// accoda una riga (o un record) nel blocco del file, scrivendo e ruotando il file quando serve
+static void batch_line(int kind, const void *line, size_t len)
+{
+    if (g_batch[kind].used + len > sizeof(g_batch[kind].data))
+        batch_flush(kind);
+    if (g_log.sinks[kind].path && g_log.sinks[kind].file_size + (off_t)(g_batch[kind].used + len) > LOG_ROTATE_SIZE)
+    {
+        batch_flush(kind);
+        sink_rotate(kind);
+    }
+    if (len > sizeof(g_batch[kind].data))
+        len = sizeof(g_batch[kind].data);
+    memcpy(g_batch[kind].data + g_batch[kind].used, line, len);
+    g_batch[kind].used += len;
+}
+
+// prefisso "[data ora] [nome] " ricalcolato solo quando cambia il secondo
+static const char *line_prefix(int64_t t, size_t *len)
+{
+    static int64_t cached_time = -1;
+    static char cached[192];
+    static size_t cached_len;
+    if (t != cached_time)
+    {
+        time_t now = (time_t)t;
+        struct tm tm;
+        char timestr[64];
+        localtime_r(&now, &tm);
+        strftime(timestr, sizeof(timestr), "%Y-%m-%d %H:%M:%S", &tm);
+        cached_len = snprintf(cached, sizeof(cached), "[%s] [%s] ", timestr, g_log.name);
+        if (cached_len >= sizeof(cached))
+            cached_len = sizeof(cached) - 1;
+        cached_time = t;
+    }
+    *len = cached_len;
+    return cached;
+}
+
+// svuota tutti i ring nel blocco di scrittura, restituisce il numero di record letti
+static int drain_rings()
+{
+    int records = 0;
+    unsigned long dropped = 0;
+    char line[192 + LOG_LINE_MAX + 1];
+    for (log_ring *r = __atomic_load_n(&g_log.rings, __ATOMIC_ACQUIRE); r; r = r->next)
+    {
+        dropped += __atomic_load_n(&r->dropped, __ATOMIC_RELAXED);
+        uint32_t head = __atomic_load_n(&r->head, __ATOMIC_SEQ_CST);
+        uint32_t tail = r->tail;
+        while (tail != head)
+        {
+            log_header h;
+            ring_get(r, tail, &h, sizeof(h));
+            if (h.kind != LOG_KIND_TEXT)
+            {
+                // evento o messaggio per la console: scritto cosi' com'e'
+                ring_get(r, tail + sizeof(h), line, h.len);
+                batch_line(h.kind, line, h.len);
+                tail += sizeof(h) + h.len;
+                records++;
+                continue;
+            }
+            size_t prefix_len;
+            const char *prefix = line_prefix(h.time, &prefix_len);
+            memcpy(line, prefix, prefix_len);
+            ring_get(r, tail + sizeof(h), line + prefix_len, h.len);
+            line[prefix_len + h.len] = '\n';
+            batch_line(LOG_KIND_TEXT, line, prefix_len + h.len + 1);
+            tail += sizeof(h) + h.len;
+            records++;
+        }
+        // libera lo spazio letto per il produttore
+        __atomic_store_n(&r->tail, tail, __ATOMIC_RELEASE);
+    }
+    if (dropped > g_log.dropped_reported)
+    {
+        size_t prefix_len;
+        const char *prefix = line_prefix(time(NULL), &prefix_len);
+        int n = snprintf(line, sizeof(line), "%s[LOG] %lu messaggi di log persi (buffer pieno)\n", prefix, dropped - g_log.dropped_reported);
+        batch_line(LOG_KIND_TEXT, line, n);
+        g_log.dropped_reported = dropped;
+    }
+    return records;
+}
+
+static void *writer_thread(void *arg)
+{
+    (void)arg;
+    for (;;)
+    {
+        int records = drain_rings();
+        for (int kind = 0; kind < LOG_KINDS; kind++)
+            batch_flush(kind);
+        if (records > 0)
+            continue;
+
+        // annuncia l'attesa, poi ricontrolla: un record pubblicato prima dell'annuncio
+        // viene visto qui, uno pubblicato dopo scrive sull'eventfd
+        __atomic_store_n(&g_log.sleeping, 1, __ATOMIC_SEQ_CST);
+        records = drain_rings();
+        for (int kind = 0; kind < LOG_KINDS; kind++)
+            batch_flush(kind);
+        if (records > 0)
+        {
+            __atomic_store_n(&g_log.sleeping, 0, __ATOMIC_SEQ_CST);
+            continue;
+        }
+        if (__atomic_load_n(&g_log.stop, __ATOMIC_ACQUIRE))
+            break;
+
+        struct pollfd pfd = {.fd = g_log.wake_fd, .events = POLLIN};
+        if (poll(&pfd, 1, -1) > 0)
+        {
+            uint64_t count;
+            if (read(g_log.wake_fd, &count, sizeof(count)) < 0)
+            {
+                // EAGAIN: risveglio gia' consumato
+            }
+        }
+        __atomic_store_n(&g_log.sleeping, 0, __ATOMIC_SEQ_CST);
+    }
+    return NULL;
+}
+
+// ======================= API =======================
+
+int asynclog_open(const char *path, const char *events_path, const char *name)
+{
+    g_log.sinks[LOG_KIND_TEXT].path = strdup(path);
+    g_log.sinks[LOG_KIND_EVENT].path = events_path ? strdup(events_path) : NULL;
+    g_log.wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (!g_log.sinks[LOG_KIND_TEXT].path || (events_path && !g_log.sinks[LOG_KIND_EVENT].path) || g_log.wake_fd < 0 ||
+        sink_open(LOG_KIND_TEXT) < 0 || (events_path && sink_open(LOG_KIND_EVENT) < 0))
+    {
+        asynclog_close();
+        return -1;
+    }
+    g_log.events = events_path != NULL;
+    // quanto stampato finora con stdio precede i messaggi scritti dal writer
+    fflush(stdout);
+    g_log.sinks[LOG_KIND_CONSOLE].fd = STDOUT_FILENO;
+    strncpy(g_log.name, name, sizeof(g_log.name) - 1);
+
+    g_log.stop = false;
+    if (pthread_create(&g_log.writer, NULL, writer_thread, NULL) != 0)
+    {
+        asynclog_close();
+        return -1;
+    }
+    __atomic_store_n(&g_log.running, true, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void asynclog_close()
+{
+    if (__atomic_exchange_n(&g_log.running, false, __ATOMIC_ACQ_REL))
+    {
+        // il writer scrive tutto cio' che e' gia' accodato prima di uscire
+        __atomic_store_n(&g_log.stop, true, __ATOMIC_RELEASE);
+        uint64_t one = 1;
+        if (write(g_log.wake_fd, &one, sizeof(one)) < 0)
+        {
+            // eventfd non bloccante: il contatore e' gia' diverso da zero
+        }
+        pthread_join(g_log.writer, NULL);
+    }
+    for (int kind = 0; kind < LOG_KINDS; kind++)
+    {
+        if (g_log.sinks[kind].path && g_log.sinks[kind].fd >= 0)
+            close(g_log.sinks[kind].fd);
+        g_log.sinks[kind].fd = -1;
+        free(g_log.sinks[kind].path);
+        g_log.sinks[kind].path = NULL;
+        g_batch[kind].used = 0;
+    }
+    if (g_log.wake_fd >= 0)
+        close(g_log.wake_fd);
+    g_log.wake_fd = -1;
+    g_log.events = false;
+}
@@ -0,0 +1,79 @@
+/*
+asynclog.h
+    log su file asincrono
+
+    ogni thread che scrive nel log possiede un ring buffer (un solo produttore, un solo
+    consumatore) in cui accoda record gia' formattati: nessun lock condiviso, nessuna
+    conversione del timestamp e nessuna scrittura su file nel thread chiamante.
+    un thread writer dedicato svuota tutti i ring, aggiunge il timestamp (la stringa
+    viene ricalcolata solo quando cambia il secondo) e scrive i record a blocchi con
+    una sola write. quando il file supera LOG_ROTATE_SIZE viene ruotato:
+        paroliere.log -> paroliere.log.1 -> ... -> paroliere.log.LOG_ROTATE_KEEP (eliminato)
+
+    se il ring del thread resta pieno anche dopo aver ceduto il processore al writer
+    il record viene scartato e conteggiato: il writer riporta nel log il numero di
+    record persi. il writer dorme su un eventfd quando tutti i ring sono vuoti e
+    viene risvegliato dal primo record successivo.
+
+    nello stesso ring passano anche i record binari del log degli eventi (eventlog.h):
+    il writer li scrive senza conversioni in un secondo file, ruotato allo stesso modo.
+    allo stesso modo passano i messaggi per la console, scritti dal writer su stdout:
+    un terminale o una pipe lenti fermano solo il writer, mai il thread chiamante.
+*/
+
+#ifndef ASYNCLOG_H
+#define ASYNCLOG_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define LOG_RING_SIZE (32 * 1024)          // byte del ring di ogni thread (potenza di 2)
+#define LOG_LINE_MAX 2048                  // testo di un record (oltre viene troncato)
+#define LOG_BATCH_SIZE (64 * 1024)         // byte scritti dal writer con una sola write
+#define LOG_ROTATE_SIZE (16 * 1024 * 1024) // dimensione del file oltre la quale viene ruotato
+#define LOG_ROTATE_KEEP 3                  // file ruotati conservati
+#define LOG_FULL_RETRIES 64                // cessioni del processore al writer prima di scartare un record
+
+/*
+    asynclog_open:
+        apre (in append) il file di log 'path' e il log degli eventi 'events_path'
+        (NULL per non registrare gli eventi) e avvia il thread writer; 'name' viene
+        riportato in ogni riga. restituisce 0 in caso di successo, -1 in caso di errore
+*/
+int asynclog_open(const char *path, const char *events_path, const char *name);
+
+/*
+    asynclog_vwrite:
+        formatta il messaggio e lo accoda nel ring del thread chiamante, senza bloccare.
+        non fa nulla se il log non e' aperto. non e' async-signal-safe (vsnprintf, e alla
+        prima chiamata del thread un mutex e un'allocazione): non va usata da un signal handler
+*/
+void asynclog_vwrite(const char *format, va_list args);
+
+/*
+    asynclog_event:
+        accoda nel ring del thread chiamante il record binario 'record' di 'len' byte,
+        scritto senza modifiche nel log degli eventi. stessi vincoli di asynclog_vwrite;
+        non fa nulla se il log degli eventi non e' aperto
+    si assume che:
+        - len <= LOG_LINE_MAX
+*/
+void asynclog_event(const void *record, size_t len);
+
+/*
+    asynclog_console:
+        formatta il messaggio e lo accoda per la console (scritto dal writer su stdout cosi'
+        com'e', senza timestamp). restituisce false, senza usare args, se il log non e' aperto:
+        in quel caso il chiamante scrive direttamente
+*/
+bool asynclog_console(const char *format, va_list args);
+
+/*
+    asynclog_close:
+        attende che il writer abbia scritto tutti i record accodati, lo termina e chiude il file.
+        i record accodati dopo la chiamata vengono ignorati
+*/
+void asynclog_close();
+
+#endif // ASYNCLOG_H
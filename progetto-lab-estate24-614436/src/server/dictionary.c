@@ -1,36 +1,57 @@
 #include "dictionary.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ======================= costruzione (trie temporaneo) =======================
+/*
+    durante il caricamento le parole vengono inserite in un pool temporaneo di nodi
+    con 27 indici a 32 bit (0 = figlio assente, la radice e' il nodo 0 e non puo'
+    essere figlio di nessuno). a caricamento concluso il pool viene compattato
+    nel formato definitivo (trie_packed_node + edges) e liberato.
+*/
+typedef struct
+{
+    uint32_t children[ALPHABET_SIZE];
+    bool end_of_word;
+} build_node;
+
+typedef struct
+{
+    build_node *nodes;
+    uint32_t count;
+    uint32_t capacity;
+} trie_builder;
+
 //======================= creazione nuovo nodo trie =======================
-trie_node *trie_create_node(void)
+static uint32_t trie_create_node(trie_builder *b)
 {
-    trie_node *node = (trie_node *)malloc(sizeof(trie_node));
-    if (node)
+    if (b->count == b->capacity)
     {
-        node->end_of_word = false;
-        for (int i = 0; i < ALPHABET_SIZE; i++)
-        {
-            node->children[i] = NULL;
-        }
+        uint32_t new_capacity = b->capacity ? b->capacity * 2 : 1024;
+        build_node *tmp = realloc(b->nodes, (size_t)new_capacity * sizeof(build_node));
+        if (!tmp)
+            return 0;
+        b->nodes = tmp;
+        b->capacity = new_capacity;
     }
-    return node;
+    memset(&b->nodes[b->count], 0, sizeof(build_node));
+    return b->count++;
 }
 
-// ======================= inserzione parola nel trie =======================
-void trie_insert(trie_node *root, const char *word)
+// ======================= tokenizzazione =======================
+/*
+    word_to_tokens:
+        converte una parola nella sequenza di indici usata dal trie (0..25 = 'a'..'z', 26 = "qu").
+        come in fase di inserimento, ignora caratteri non alfabetici e 'q' non seguite da 'u'.
+        restituisce il numero di token scritti in 'tokens' (al massimo 255).
+*/
+static int word_to_tokens(const char *word, uint8_t tokens[255])
 {
-    if (word == NULL)
-    {
-        printf("Errore: la parola non può essere NULL.\n");
-        return;
-    }
-    int word_len = strlen(word);
-    if (word_len == 0 || word_len > 255)
-    {
-        printf("Errore: la lunghezza della parola deve essere compresa tra 1 e 255 caratteri.\n");
-        return;
-    }
-    // TODO: Stessi controlli di prima, world_len, word != NULL, ecc.
-    trie_node *curr = root;
-    for (int i = 0; word[i]; i++)
+    int n = 0;
+    for (int i = 0; word[i] && n < 255; i++)
     {
         char c = (char)tolower((unsigned char)word[i]);
         // se trovia una q, verifichiamo sia seguito da u
@@ -41,51 +62,324 @@ void trie_insert(trie_node *root, const char *word)
                 // se c'e' una 'q' non seguita da 'u', ignoriamo
                 continue;
             }
-
             // qu come unico token, indice 26
-            int index = 26;
-            if (!curr->children[index])
-            {
-                curr->children[index] = trie_create_node();
-            }
-            curr = curr->children[index];
+            tokens[n++] = 26;
             i++; // salta 'u'
             continue;
         }
         // ignora caratteri non alfabetici
         if (c < 'a' || c > 'z')
             continue;
-
-        int index = c - 'a';
-
-        if (!curr->children[index])
-        {
-            curr->children[index] = trie_create_node();
-        }
-        curr = curr->children[index];
+        tokens[n++] = (uint8_t)(c - 'a');
     }
-    curr->end_of_word = true;
+    return n;
 }
 
-//======================= ricerca =======================
-bool trie_search(trie_node *root, const char *word)
+static bool check_word(const char *word)
 {
     if (word == NULL)
     {
         printf("Errore: la parola non può essere NULL.\n");
         return false;
     }
-
     int word_len = strlen(word);
     if (word_len == 0 || word_len > 255)
     {
         printf("Errore: la lunghezza della parola deve essere compresa tra 1 e 255 caratteri.\n");
         return false;
     }
-    trie_node *curr = root;
+    return true;
+}
+
+// ======================= inserzione parola nel trie =======================
+static bool trie_insert(trie_builder *b, const char *word)
+{
+    if (!check_word(word))
+        return true;
+
+    uint8_t tokens[255];
+    int n = word_to_tokens(word, tokens);
+    uint32_t curr = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (!b->nodes[curr].children[tokens[i]])
+        {
+            uint32_t child = trie_create_node(b);
+            if (!child)
+                return false; // memoria esaurita
+            b->nodes[curr].children[tokens[i]] = child;
+        }
+        curr = b->nodes[curr].children[tokens[i]];
+    }
+    b->nodes[curr].end_of_word = true;
+    return true;
+}
+
+// ======================= DAWG (grafo aciclico minimo) =======================
+/*
+    costruzione incrementale di Daciuk et al. da input ordinato: le parole vengono
+    tokenizzate, ordinate e inserite una alla volta. il ramo della parola
+    precedente che non e' condiviso con quella corrente non verra' piu' toccato,
+    quindi viene minimizzato subito: ogni suo nodo viene sostituito con un nodo
+    equivalente gia' registrato (stessi figli, stesso flag di fine parola), se
+    esiste. le desinenze comuni (-are, -ando, -azione, ...) finiscono cosi' per
+    essere condivise. il risultato viene compattato con trie_pack come il trie.
+*/
+typedef struct
+{
+    trie_builder b;
+    uint32_t *reg; // tabella hash (indirizzamento aperto) dei nodi minimizzati, 0 = vuoto
+    uint32_t reg_capacity;
+    uint32_t reg_count;
+    uint32_t free_head; // nodi scartati riutilizzabili (collegati tramite children[0])
+
+    // ramo non ancora minimizzato: path_child[i] e' il figlio di path_parent[i] per il token i
+    uint32_t path_parent[255];
+    uint32_t path_child[255];
+    uint8_t path_token[255];
+    int path_len;
+} dawg_builder;
+
+static uint32_t dawg_hash(const build_node *n)
+{
+    uint32_t h = n->end_of_word ? 0x9e3779b9u : 0;
+    for (int i = 0; i < ALPHABET_SIZE; i++)
+    {
+        h ^= n->children[i] + 0x9e3779b9u + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+static bool dawg_equal(const build_node *a, const build_node *b)
+{
+    return a->end_of_word == b->end_of_word &&
+           memcmp(a->children, b->children, sizeof(a->children)) == 0;
+}
+
+static uint32_t dawg_new_node(dawg_builder *d)
+{
+    if (d->free_head)
+    {
+        uint32_t id = d->free_head;
+        d->free_head = d->b.nodes[id].children[0];
+        memset(&d->b.nodes[id], 0, sizeof(build_node));
+        return id;
+    }
+    return trie_create_node(&d->b);
+}
+
+static bool dawg_register_grow(dawg_builder *d)
+{
+    uint32_t new_capacity = d->reg_capacity ? d->reg_capacity * 2 : 4096;
+    uint32_t *tmp = calloc(new_capacity, sizeof(uint32_t));
+    if (!tmp)
+        return false;
+    for (uint32_t i = 0; i < d->reg_capacity; i++)
+    {
+        uint32_t id = d->reg[i];
+        if (!id)
+            continue;
+        uint32_t pos = dawg_hash(&d->b.nodes[id]) & (new_capacity - 1);
+        while (tmp[pos])
+            pos = (pos + 1) & (new_capacity - 1);
+        tmp[pos] = id;
+    }
+    free(d->reg);
+    d->reg = tmp;
+    d->reg_capacity = new_capacity;
+    return true;
+}
+
+/*
+    dawg_register:
+        restituisce il nodo registrato equivalente a 'id', registrando 'id' stesso se non
+        ne esiste uno. restituisce 0 se la memoria e' esaurita.
+*/
+static uint32_t dawg_register(dawg_builder *d, uint32_t id)
+{
+    if ((d->reg_count + 1) * 2 > d->reg_capacity && !dawg_register_grow(d))
+        return 0;
+    const build_node *n = &d->b.nodes[id];
+    uint32_t pos = dawg_hash(n) & (d->reg_capacity - 1);
+    while (d->reg[pos])
+    {
+        if (dawg_equal(&d->b.nodes[d->reg[pos]], n))
+            return d->reg[pos];
+        pos = (pos + 1) & (d->reg_capacity - 1);
+    }
+    d->reg[pos] = id;
+    d->reg_count++;
+    return id;
+}
+
+// minimizza il ramo corrente dal fondo fino alla profondita' 'down_to'
+static bool dawg_minimize(dawg_builder *d, int down_to)
+{
+    while (d->path_len > down_to)
+    {
+        int i = --d->path_len;
+        uint32_t child = d->path_child[i];
+        uint32_t same = dawg_register(d, child);
+        if (!same)
+            return false;
+        if (same != child)
+        {
+            d->b.nodes[d->path_parent[i]].children[d->path_token[i]] = same;
+            d->b.nodes[child].children[0] = d->free_head;
+            d->free_head = child;
+        }
+    }
+    return true;
+}
+
+// inserisce una parola tokenizzata, maggiore o uguale a quella precedente
+static bool dawg_insert(dawg_builder *d, const uint8_t *tokens, int n)
+{
+    int common = 0;
+    while (common < n && common < d->path_len && d->path_token[common] == tokens[common])
+        common++;
+    if (!dawg_minimize(d, common))
+        return false;
+
+    uint32_t curr = common ? d->path_child[common - 1] : 0;
+    for (int i = common; i < n; i++)
+    {
+        uint32_t child = dawg_new_node(d);
+        if (!child)
+            return false;
+        d->b.nodes[curr].children[tokens[i]] = child;
+        d->path_parent[d->path_len] = curr;
+        d->path_child[d->path_len] = child;
+        d->path_token[d->path_len] = tokens[i];
+        d->path_len++;
+        curr = child;
+    }
+    d->b.nodes[curr].end_of_word = true;
+    return true;
+}
+
+// parole tokenizzate in un'unica area: [lunghezza][token...]
+typedef struct
+{
+    uint8_t *data;
+    size_t len;
+    size_t capacity;
+    size_t count;
+} token_arena;
+
+static bool arena_add_word(void *ctx, const char *word)
+{
+    token_arena *a = ctx;
+    if (!check_word(word))
+        return true;
+    if (a->len + 256 > a->capacity)
+    {
+        size_t new_capacity = a->capacity ? a->capacity * 2 : 1 << 20;
+        uint8_t *tmp = realloc(a->data, new_capacity);
+        if (!tmp)
+            return false;
+        a->data = tmp;
+        a->capacity = new_capacity;
+    }
+    int n = word_to_tokens(word, a->data + a->len + 1);
+    a->data[a->len] = (uint8_t)n;
+    a->len += n + 1;
+    a->count++;
+    return true;
+}
+
+static int token_word_cmp(const void *pa, const void *pb)
+{
+    const uint8_t *a = *(const uint8_t *const *)pa;
+    const uint8_t *b = *(const uint8_t *const *)pb;
+    int la = a[0], lb = b[0];
+    int r = memcmp(a + 1, b + 1, la < lb ? la : lb);
+    return r ? r : la - lb;
+}
+
+// ======================= compattazione =======================
+/*
+    trie_pack:
+        visita in ampiezza la struttura temporanea (trie o DAWG) e produce il pool
+        compatto: i nodi vengono rinumerati in ordine BFS, quindi i livelli alti
+        (i piu' visitati dalle ricerche) stanno in poche linee di cache contigue.
+        un nodo del DAWG puo' avere piu' padri: 'map' evita di duplicarlo.
+*/
+static trie_node *trie_pack(const trie_builder *b)
+{
+    trie_node *dict = calloc(1, sizeof(trie_node));
+    uint32_t *queue = malloc((size_t)b->count * sizeof(uint32_t));
+    uint32_t *map = malloc((size_t)b->count * sizeof(uint32_t));
+    uint32_t edge_capacity = b->count;
+    if (dict)
+    {
+        dict->nodes = malloc((size_t)b->count * sizeof(trie_packed_node));
+        dict->edges = malloc((size_t)edge_capacity * sizeof(uint32_t));
+    }
+    if (!dict || !queue || !map || !dict->nodes || !dict->edges)
+    {
+        free(queue);
+        free(map);
+        trie_free(dict);
+        return NULL;
+    }
+    memset(map, 0xff, (size_t)b->count * sizeof(uint32_t)); // UINT32_MAX = non ancora visitato
+
+    // la posizione in coda coincide con il nuovo indice del nodo
+    uint32_t tail = 0;
+    map[0] = 0;
+    queue[tail++] = 0;
+    for (uint32_t head = 0; head < tail; head++)
+    {
+        const build_node *old = &b->nodes[queue[head]];
+        trie_packed_node *out = &dict->nodes[head];
+        out->mask = old->end_of_word ? TRIE_END_OF_WORD : 0;
+        out->first_edge = dict->edge_count;
+        for (int i = 0; i < ALPHABET_SIZE; i++)
+        {
+            uint32_t child = old->children[i];
+            if (!child)
+                continue;
+            if (map[child] == UINT32_MAX)
+            {
+                map[child] = tail;
+                queue[tail++] = child;
+            }
+            if (dict->edge_count == edge_capacity)
+            {
+                uint32_t *tmp = realloc(dict->edges, (size_t)edge_capacity * 2 * sizeof(uint32_t));
+                if (!tmp)
+                {
+                    free(queue);
+                    free(map);
+                    trie_free(dict);
+                    return NULL;
+                }
+                dict->edges = tmp;
+                edge_capacity *= 2;
+            }
+            out->mask |= 1u << i;
+            dict->edges[dict->edge_count++] = map[child];
+        }
+    }
+    dict->node_count = tail;
+    free(queue);
+    free(map);
+    return dict;
+}
+
+//======================= ricerca =======================
+bool trie_search(trie_node *root, const char *word)
+{
+    if (!check_word(word))
+        return false;
+
+    const trie_packed_node *nodes = root->nodes;
+    uint32_t curr = 0;
     for (int i = 0; word[i]; i++)
     {
         char c = (char)tolower((unsigned char)word[i]);
+        int index;
 
         if (c == 'q')
         {
@@ -93,54 +387,201 @@ bool trie_search(trie_node *root, const char *word)
             {
                 return false;
             }
-            int index = 26;
-            if (!curr->children[index])
-                return false;
-            curr = curr->children[index];
+            index = 26;
             i++; // salta 'u'
-            continue;
         }
-        if (c < 'a' || c > 'z')
+        else if (c < 'a' || c > 'z')
+        {
             continue;
-        int index = c - 'a';
-        if (!curr->children[index])
+        }
+        else
+        {
+            index = c - 'a';
+        }
+
+        uint32_t bit = 1u << index;
+        uint32_t mask = nodes[curr].mask;
+        if (!(mask & bit))
             return false;
-        curr = curr->children[index];
+        // rank: numero di figli con indice minore di quello cercato
+        curr = root->edges[nodes[curr].first_edge + __builtin_popcount(mask & (bit - 1))];
     }
-    // se la posizione e' valida ed end_of_word == true, allora esiste
-    return (curr && curr->end_of_word);
+    // se la posizione e' valida ed e' fine parola, allora esiste
+    return (nodes[curr].mask & TRIE_END_OF_WORD) != 0;
 }
 
 // trie_free
-// dealloca ricorsivamente
+// dealloca il pool di nodi e l'array degli archi (o rilascia la mappatura dell'immagine)
 void trie_free(trie_node *node)
 {
     if (!node)
         return;
-    for (int i = 0; i < ALPHABET_SIZE; i++)
+    if (node->map_base)
     {
-        trie_free(node->children[i]);
+        munmap(node->map_base, node->map_len);
+    }
+    else
+    {
+        free(node->nodes);
+        free(node->edges);
     }
     free(node);
 }
 
-// ======================= caricamento dizionario =======================
+// ======================= immagine binaria =======================
+bool dictionary_is_image(const char *filename)
+{
+    if (filename == NULL)
+        return false;
+    FILE *fp = fopen(filename, "rb");
+    if (!fp)
+        return false;
+    char magic[8];
+    bool is_image = fread(magic, 1, sizeof(magic), fp) == sizeof(magic) &&
+                    memcmp(magic, DICT_IMAGE_MAGIC, sizeof(magic)) == 0;
+    fclose(fp);
+    return is_image;
+}
 
-void *load_dictionary_trie(const char *filename)
+int save_dictionary_image(const trie_node *dict, const char *filename)
+{
+    if (dict == NULL || filename == NULL)
+        return -1;
+
+    char tmp_name[4096];
+    snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", filename);
+    FILE *fp = fopen(tmp_name, "wb");
+    if (!fp)
+    {
+        perror("fopen immagine dizionario");
+        return -1;
+    }
+
+    dict_image_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DICT_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = DICT_IMAGE_VERSION;
+    header.byte_order = DICT_IMAGE_BYTE_ORDER;
+    header.node_count = dict->node_count;
+    header.edge_count = dict->edge_count;
+
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+              fwrite(dict->nodes, sizeof(trie_packed_node), dict->node_count, fp) == dict->node_count &&
+              fwrite(dict->edges, sizeof(uint32_t), dict->edge_count, fp) == dict->edge_count;
+    if (fclose(fp) != 0)
+        ok = false;
+    if (!ok || rename(tmp_name, filename) != 0)
+    {
+        perror("scrittura immagine dizionario");
+        remove(tmp_name);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+    image_is_consistent:
+        controlla che ogni nodo dell'immagine usi solo bit validi della mask e che i suoi
+        archi (first_edge .. first_edge + figli - 1) siano dentro edges[], e che ogni arco
+        punti a un nodo esistente: un'immagine troncata o danneggiata viene rifiutata invece
+        di provocare letture fuori dai limiti in trie_search e solve_board. O(nodi + archi)
+*/
+static bool image_is_consistent(const trie_packed_node *nodes, uint32_t node_count, const uint32_t *edges, uint32_t edge_count)
+{
+    const uint32_t valid_bits = TRIE_END_OF_WORD | ((1u << ALPHABET_SIZE) - 1);
+    for (uint32_t i = 0; i < node_count; i++)
+    {
+        if (nodes[i].mask & ~valid_bits)
+            return false;
+        uint32_t children = __builtin_popcount(nodes[i].mask & ~TRIE_END_OF_WORD);
+        if ((uint64_t)nodes[i].first_edge + children > edge_count)
+            return false;
+    }
+    for (uint32_t i = 0; i < edge_count; i++)
+    {
+        if (edges[i] >= node_count)
+            return false;
+    }
+    return true;
+}
+
+void *load_dictionary_image(const char *filename)
 {
     if (filename == NULL)
     {
         printf("Errore: il nome del file del dizionario non può essere NULL.\n");
         return NULL;
     }
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        perror("open immagine dizionario");
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(dict_image_header))
+    {
+        fprintf(stderr, "Errore: immagine del dizionario %s non valida\n", filename);
+        close(fd);
+        return NULL;
+    }
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // la mappatura resta valida anche dopo la chiusura
+    if (base == MAP_FAILED)
+    {
+        perror("mmap immagine dizionario");
+        return NULL;
+    }
+
+    const dict_image_header *header = base;
+    size_t expected = sizeof(dict_image_header) +
+                      (size_t)header->node_count * sizeof(trie_packed_node) +
+                      (size_t)header->edge_count * sizeof(uint32_t);
+    trie_node *dict = NULL;
+    if (memcmp(header->magic, DICT_IMAGE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != DICT_IMAGE_VERSION ||
+        header->byte_order != DICT_IMAGE_BYTE_ORDER ||
+        header->node_count == 0 ||
+        expected != (size_t)st.st_size ||
+        !image_is_consistent((const trie_packed_node *)((const char *)base + sizeof(dict_image_header)), header->node_count,
+                             (const uint32_t *)((const char *)base + sizeof(dict_image_header) + (size_t)header->node_count * sizeof(trie_packed_node)),
+                             header->edge_count) ||
+        (dict = calloc(1, sizeof(trie_node))) == NULL)
+    {
+        fprintf(stderr, "Errore: immagine del dizionario %s non valida o incompatibile\n", filename);
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+
+    dict->map_base = base;
+    dict->map_len = (size_t)st.st_size;
+    dict->node_count = header->node_count;
+    dict->edge_count = header->edge_count;
+    dict->nodes = (trie_packed_node *)((char *)base + sizeof(dict_image_header));
+    dict->edges = (uint32_t *)(dict->nodes + dict->node_count);
+    return (void *)dict;
+}
+
+// ======================= caricamento dizionario =======================
+/*
+    read_dictionary_file:
+        legge il file riga per riga e passa ogni parola non vuota a 'on_word'.
+        restituisce false se il file non e' leggibile o se 'on_word' fallisce.
+*/
+static bool read_dictionary_file(const char *filename, bool (*on_word)(void *ctx, const char *word), void *ctx)
+{
+    if (filename == NULL)
+    {
+        printf("Errore: il nome del file del dizionario non può essere NULL.\n");
+        return false;
+    }
 
     FILE *fp = fopen(filename, "r");
     if (!fp)
     {
         perror("fopen dizionario");
-        return NULL;
+        return false;
     }
-    trie_node *root = trie_create_node();
     char buffer[256];
     while (fgets(buffer, sizeof(buffer), fp))
     {
@@ -155,8 +596,78 @@ void *load_dictionary_trie(const char *filename)
         {
             continue;
         }
-        trie_insert(root, buffer);
+        if (!on_word(ctx, buffer))
+        {
+            fprintf(stderr, "Errore: memoria esaurita durante il caricamento del dizionario\n");
+            fclose(fp);
+            return false;
+        }
     }
     fclose(fp);
+    return true;
+}
+
+static bool builder_add_word(void *ctx, const char *word)
+{
+    return trie_insert((trie_builder *)ctx, word);
+}
+
+void *load_dictionary_trie(const char *filename)
+{
+    trie_builder builder = {NULL, 0, 0};
+    trie_create_node(&builder); // radice, indice 0
+    if (builder.count == 0 || !read_dictionary_file(filename, builder_add_word, &builder))
+    {
+        free(builder.nodes);
+        return NULL;
+    }
+
+    trie_node *root = trie_pack(&builder);
+    free(builder.nodes);
     return (void *)root;
-}
\ No newline at end of file
+}
+
+void *load_dictionary_dawg(const char *filename)
+{
+    token_arena arena = {NULL, 0, 0, 0};
+    if (!read_dictionary_file(filename, arena_add_word, &arena))
+    {
+        free(arena.data);
+        return NULL;
+    }
+
+    // l'algoritmo richiede le parole in ordine (per token, quindi "qu" dopo "z")
+    const uint8_t **words = malloc((arena.count ? arena.count : 1) * sizeof(uint8_t *));
+    dawg_builder *d = calloc(1, sizeof(dawg_builder));
+    trie_node *root = NULL;
+    if (words && d && trie_create_node(&d->b) == 0 && d->b.count == 1)
+    {
+        size_t off = 0;
+        for (size_t i = 0; i < arena.count; i++)
+        {
+            words[i] = arena.data + off;
+            off += arena.data[off] + 1;
+        }
+        qsort(words, arena.count, sizeof(uint8_t *), token_word_cmp);
+
+        bool ok = true;
+        for (size_t i = 0; i < arena.count && ok; i++)
+        {
+            if (i > 0 && token_word_cmp(&words[i - 1], &words[i]) == 0)
+                continue; // duplicato
+            ok = dawg_insert(d, words[i] + 1, words[i][0]);
+        }
+        if (ok && dawg_minimize(d, 0))
+            root = trie_pack(&d->b);
+    }
+
+    if (d)
+    {
+        free(d->b.nodes);
+        free(d->reg);
+    }
+    free(d);
+    free(words);
+    free(arena.data);
+    return (void *)root;
+}
@@ -3,25 +3,90 @@ dictionary.h
     gestione dizionario tramite struttura trie
     ogni riga del file contiene una parola (terminata da newline)
     ricerca case-insensitive
+
+    il trie viene costruito una sola volta all'avvio e poi compattato in un
+    pool contiguo di nodi: ogni nodo contiene una bitmap dei figli presenti e
+    l'indice del primo arco in un array di archi compatto (rank = popcount).
+    la struttura usa solo indici, quindi puo' essere salvata cosi' com'e' in un
+    file immagine e rimappata in memoria (mmap) da altri processi.
 */
 
 #ifndef DICTIONARY_H
 #define DICTIONARY_H
 
+#define _GNU_SOURCE // mmap/fileno con -std=c99
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <ctype.h>
 
 #define ALPHABET_SIZE 27 // aggiunta per un indice per 'qu'
 
+#define TRIE_END_OF_WORD (1u << 31) // bit della mask che segnala fine parola
+
+// nodo compattato: 8 byte invece di 27 puntatori
+typedef struct
+{
+    uint32_t mask;       // bit i (0..26) = figlio con indice i presente, bit 31 = fine parola
+    uint32_t first_edge; // indice in edges[] del primo figlio (ordine alfabetico)
+} trie_packed_node;
+
+/*
+    trie_node:
+        dizionario compattato, il nome e' mantenuto per compatibilita' con l'API
+        esistente (trie_search/trie_free). la radice e' sempre il nodo 0.
+*/
 typedef struct trie_node
 {
-    bool end_of_word;
-    struct trie_node *children[ALPHABET_SIZE];
+    trie_packed_node *nodes;
+    uint32_t *edges; // edges[first_edge + rank] = indice del nodo figlio
+    uint32_t node_count;
+    uint32_t edge_count;
+
+    // se diverso da NULL, nodes/edges puntano dentro un'immagine mappata in sola lettura
+    void *map_base;
+    size_t map_len;
 } trie_node;
 
+#define TRIE_NO_NODE UINT32_MAX
+
+/*
+    trie_child / trie_is_word:
+        navigazione nodo per nodo, usata dal risolutore della matrice per visitare
+        trie e griglia insieme. la radice e' il nodo 0; 'index' e' il token (0..26).
+        trie_child restituisce TRIE_NO_NODE se il figlio non esiste.
+*/
+static inline uint32_t trie_child(const trie_node *dict, uint32_t node, int index)
+{
+    uint32_t bit = 1u << index;
+    uint32_t mask = dict->nodes[node].mask;
+    if (!(mask & bit))
+        return TRIE_NO_NODE;
+    return dict->edges[dict->nodes[node].first_edge + __builtin_popcount(mask & (bit - 1))];
+}
+
+static inline bool trie_is_word(const trie_node *dict, uint32_t node)
+{
+    return (dict->nodes[node].mask & TRIE_END_OF_WORD) != 0;
+}
+
+// intestazione del file immagine, seguita da nodes[node_count] e edges[edge_count]
+#define DICT_IMAGE_MAGIC "PAROLDIZ"
+#define DICT_IMAGE_VERSION 1
+#define DICT_IMAGE_BYTE_ORDER 0x01020304u // rileva immagini prodotte su host con endianness diversa
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t node_count;
+    uint32_t edge_count;
+} dict_image_header;
+
 /*
     load_dictionary_trie:
         Carica un dizionario da file in una struttura trie.
@@ -29,9 +94,43 @@ typedef struct trie_node
 */
 void *load_dictionary_trie(const char *filename);
 
+/*
+    load_dictionary_dawg:
+        Carica il dizionario in un DAWG minimo (trie con suffissi condivisi), costruito
+        in modo incrementale dalle parole ordinate. Il risultato ha lo stesso formato del
+        trie compatto: si interroga con trie_search e si libera con trie_free.
+        Si assume che 'filename' sia una stringa valida e che il file sia formattato correttamente.
+*/
+void *load_dictionary_dawg(const char *filename);
+
+/*
+    dictionary_is_image:
+        Verifica se 'filename' e' un'immagine binaria del dizionario (controlla il magic).
+*/
+bool dictionary_is_image(const char *filename);
+
+/*
+    load_dictionary_image:
+        Mappa in memoria in sola lettura un'immagine prodotta da save_dictionary_image.
+        Non ricostruisce nulla: le pagine vengono caricate su richiesta e sono condivise
+        (page cache) tra tutti i processi che mappano lo stesso file.
+        Al caricamento l'immagine viene letta una volta per verificarne la coerenza (archi
+        dentro edges[], nodi esistenti): un file troncato, danneggiato o prodotto su un host
+        con byte order diverso viene rifiutato (restituisce NULL).
+*/
+void *load_dictionary_image(const char *filename);
+
+/*
+    save_dictionary_image:
+        Serializza il dizionario in 'filename' (scrive su un file temporaneo e poi lo
+        rinomina, cosi' i processi che hanno gia' mappato l'immagine precedente non
+        vengono disturbati). Restituisce 0 in caso di successo, -1 altrimenti.
+*/
+int save_dictionary_image(const trie_node *dict, const char *filename);
+
 /*
     trie_free:
-        Libera ricorsivamente la memoria allocata per il trie.
+        Libera la memoria allocata per il trie.
         Si assume che 'node' sia un puntatore valido o NULL.
 */
 void trie_free(trie_node *node);
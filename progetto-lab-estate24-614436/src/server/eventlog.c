@@ -0,0 +1,49 @@
+#define _GNU_SOURCE
+
+#include "eventlog.h"
+#include "asynclog.h"
+
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+void event_log(int event, int slot, unsigned int conn, const char *types, ...)
+{
+    char record[EVENT_RECORD_MAX];
+    event_header h;
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    h.time_ns = (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+    h.conn = conn;
+    h.slot = slot < 0 ? EVENT_NO_SLOT : (uint16_t)slot;
+    h.event = (uint8_t)event;
+    h.argc = 0;
+
+    // argomenti dopo l'intestazione: [tipo][lunghezza][dati]
+    size_t used = sizeof(h);
+    va_list args;
+    va_start(args, types);
+    for (const char *t = types; *t && h.argc < EVENT_MAX_ARGS; t++, h.argc++)
+    {
+        if (*t == EVENT_ARG_STR)
+        {
+            const char *s = va_arg(args, const char *);
+            size_t len = strnlen(s, EVENT_STR_MAX);
+            record[used++] = EVENT_ARG_STR;
+            record[used++] = (char)len;
+            memcpy(record + used, s, len);
+            used += len;
+        }
+        else
+        {
+            int32_t v = va_arg(args, int);
+            record[used++] = EVENT_ARG_INT;
+            record[used++] = sizeof(v);
+            memcpy(record + used, &v, sizeof(v));
+            used += sizeof(v);
+        }
+    }
+    va_end(args);
+    memcpy(record, &h, sizeof(h));
+    asynclog_event(record, used);
+}
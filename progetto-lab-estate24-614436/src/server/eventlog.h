@@ -0,0 +1,76 @@
+/*
+eventlog.h
+    log binario degli eventi ad alta frequenza (parole proposte, login, partite)
+
+    gli eventi non passano da vsnprintf: il chiamante copia evento, client e argomenti
+    tipizzati in un record binario che viene accodato nel ring del thread come i messaggi
+    di testo (asynclog.h); il thread writer lo scrive cosi' com'e' in EVENT_FILE.
+    il file si decodifica offline con paroliere_logdump (src/tools/logdump.c).
+
+    formato del file (byte order della macchina che lo ha scritto):
+        event_file_header
+        record: event_header seguito da 'argc' argomenti [1 byte tipo] [1 byte lunghezza] [dati]
+            - EVENT_ARG_INT: 4 byte (int32_t)
+            - EVENT_ARG_STR: lunghezza byte di testo, senza terminatore (al piu' 255)
+    dopo ogni rotazione il nuovo file ricomincia con l'intestazione.
+
+    eventi e argomenti:
+        EVENT_LOGIN          username (s)
+        EVENT_DISCONNECT     punti (i)
+        EVENT_WORD           parola (s), esito (i): punti, 0 se gia' proposta, ESITO_* se non valida
+        EVENT_GAME_START     durata in secondi (i), punteggio massimo della matrice (i)
+        EVENT_GAME_END       giocatori in classifica (i)
+    gli eventi della partita non riguardano un client: slot EVENT_NO_SLOT e conn 0.
+*/
+
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <stdint.h>
+
+#define EVENT_FILE "paroliere.events"
+#define EVENT_MAGIC "PAREVT1"        // 8 byte compreso il terminatore
+#define EVENT_BYTE_ORDER 0x01020304u // letto diversamente su una macchina con byte order diverso
+#define EVENT_MAX_ARGS 4
+#define EVENT_STR_MAX 255
+#define EVENT_RECORD_MAX (sizeof(event_header) + EVENT_MAX_ARGS * (2 + EVENT_STR_MAX))
+#define EVENT_NO_SLOT 0xFFFF
+
+// tipi di evento
+#define EVENT_LOGIN 1
+#define EVENT_DISCONNECT 2
+#define EVENT_WORD 3
+#define EVENT_GAME_START 4
+#define EVENT_GAME_END 5
+
+// tipi di argomento
+#define EVENT_ARG_INT 'i'
+#define EVENT_ARG_STR 's'
+
+typedef struct
+{
+    char magic[8];        // EVENT_MAGIC
+    uint32_t byte_order;  // EVENT_BYTE_ORDER
+    uint32_t header_size; // sizeof(event_header)
+} event_file_header;
+
+typedef struct
+{
+    int64_t time_ns; // CLOCK_REALTIME in nanosecondi
+    uint32_t conn;   // connessione del client nello slot (conn_id)
+    uint16_t slot;   // slot del client, EVENT_NO_SLOT se l'evento non riguarda un client
+    uint8_t event;   // EVENT_*
+    uint8_t argc;
+} event_header;
+
+/*
+    event_log:
+        accoda l'evento 'event' del client in 'slot' (connessione 'conn') nel log binario.
+        'types' elenca gli argomenti variabili: 'i' per un int, 's' per una stringa
+        (troncata a EVENT_STR_MAX byte). non fa nulla se il log non e' aperto
+    si assume che:
+        - types contenga al piu' EVENT_MAX_ARGS caratteri tra EVENT_ARG_INT e EVENT_ARG_STR
+*/
+void event_log(int event, int slot, unsigned int conn, const char *types, ...);
+
+#endif // EVENTLOG_H
@@ -0,0 +1,32 @@
+#include "frame.h"
+
+
+frame *frame_create(char type, const char *payload, unsigned int length)
+{
+    frame *f = malloc(sizeof(frame) + FRAME_HEADER_SIZE + length);
+    if (!f)
+        return NULL;
+
+    f->refcount = 1;
+    f->size = FRAME_HEADER_SIZE + length;
+
+    unsigned int netlen = htonl(length);
+    f->data[0] = type;
+    memcpy(f->data + 1, &netlen, 4);
+    if (length > 0)
+        memcpy(f->data + FRAME_HEADER_SIZE, payload, length);
+    return f;
+}
+
+frame *frame_ref(frame *f)
+{
+    if (f)
+        __atomic_add_fetch(&f->refcount, 1, __ATOMIC_RELAXED);
+    return f;
+}
+
+void frame_unref(frame *f)
+{
+    if (f && __atomic_sub_fetch(&f->refcount, 1, __ATOMIC_ACQ_REL) == 0)
+        free(f);
+}
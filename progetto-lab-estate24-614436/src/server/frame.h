@@ -0,0 +1,48 @@
+/*
+frame.h
+    messaggi del protocollo gia' serializzati, condivisi tra piu' destinatari
+
+    un frame contiene in un unico blocco contiguo l'intestazione e il contenuto
+    del messaggio ([1 byte type] [4 byte lunghezza (network order)] [data]),
+    pronto per essere scritto sul socket con una sola write o copiato nel buffer
+    di uscita di un client. i messaggi inviati a tutti i client (matrice a inizio
+    partita, classifica finale) vengono costruiti una volta sola e riusati per
+    ogni destinatario; il contatore di riferimenti permette di condividerli tra
+    thread (snapshot della partita, orchestrator, scorer, gestori delle richieste)
+    senza copiarli: il frame viene liberato quando l'ultimo riferimento viene rilasciato.
+*/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include "common/common.h"
+
+#define FRAME_HEADER_SIZE MSG_HEADER_SIZE
+
+typedef struct frame
+{
+    int refcount; // aggiornato con operazioni atomiche
+    size_t size;  // byte totali: intestazione + contenuto
+    char data[];  // [type][lunghezza][contenuto]
+} frame;
+
+/*
+    frame_create:
+        costruisce un frame con un riferimento (del chiamante) a partire da tipo e contenuto.
+        restituisce NULL se la memoria e' esaurita
+*/
+frame *frame_create(char type, const char *payload, unsigned int length);
+
+/*
+    frame_ref:
+        acquisisce un riferimento aggiuntivo e restituisce il frame (NULL se f e' NULL)
+*/
+frame *frame_ref(frame *f);
+
+/*
+    frame_unref:
+        rilascia un riferimento, liberando il frame all'ultimo rilascio (nessun effetto se f e' NULL)
+*/
+void frame_unref(frame *f);
+
+#endif // FRAME_H
@@ -0,0 +1,372 @@
+#define _GNU_SOURCE
+
+#include "leaderboard.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+// ======================= stato della classifica =======================
+
+struct lb_entry
+{
+    char username[LEADERBOARD_NAME_LEN];
+    int score;
+    struct lb_entry *prev; // lista del bucket
+    struct lb_entry *next;
+    struct lb_entry *all_next; // elementi della partita, per liberarli al reset
+    lb_player_state state;          // stato conservato mentre il giocatore e' disconnesso
+    struct lb_entry *detached_next; // catena del bucket di detached[]
+};
+
+static struct
+{
+    int *tree;       // albero di Fenwick sui bucket: tree[1..buckets]
+    lb_entry **head; // bucket b: giocatori con punteggio b, in ordine di arrivo
+    lb_entry **tail;
+    int buckets;     // punteggi 0..buckets-1 (l'ultimo raccoglie anche i superiori se non si puo' allargare)
+    int count;
+    lb_entry *all;
+    lb_entry *detached[LEADERBOARD_DETACHED_BUCKETS]; // giocatori disconnessi per nome
+    unsigned long version; // incrementato a ogni modifica
+    pthread_mutex_t mutex;
+} g_board = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+// FNV-1a sul nome del giocatore, bucket di detached[]
+static unsigned int detached_bucket(const char *username)
+{
+    uint32_t h = 2166136261u;
+    for (; *username; username++)
+    {
+        h ^= (unsigned char)*username;
+        h *= 16777619u;
+    }
+    return h & (LEADERBOARD_DETACHED_BUCKETS - 1);
+}
+
+// libera gli elementi della partita e le parole conservate dei giocatori disconnessi
+static void board_free_entries()
+{
+    while (g_board.all)
+    {
+        lb_entry *e = g_board.all;
+        g_board.all = e->all_next;
+        free(e->state.used_words);
+        free(e);
+    }
+    memset(g_board.detached, 0, sizeof(g_board.detached));
+}
+
+static int bucket_of(int score)
+{
+    return score < g_board.buckets ? score : g_board.buckets - 1;
+}
+
+static void tree_add(int bucket, int delta)
+{
+    for (int i = bucket + 1; i <= g_board.buckets; i += i & -i)
+        g_board.tree[i] += delta;
+}
+
+// giocatori nei bucket 0..bucket
+static int tree_prefix(int bucket)
+{
+    int sum = 0;
+    for (int i = bucket + 1; i > 0; i -= i & -i)
+        sum += g_board.tree[i];
+    return sum;
+}
+
+static void bucket_append(lb_entry *e)
+{
+    int b = bucket_of(e->score);
+    e->next = NULL;
+    e->prev = g_board.tail[b];
+    if (g_board.tail[b])
+        g_board.tail[b]->next = e;
+    else
+        g_board.head[b] = e;
+    g_board.tail[b] = e;
+    tree_add(b, 1);
+}
+
+static void bucket_unlink(lb_entry *e)
+{
+    int b = bucket_of(e->score);
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        g_board.head[b] = e->next;
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        g_board.tail[b] = e->prev;
+    e->prev = e->next = NULL;
+    tree_add(b, -1);
+}
+
+/*
+    board_alloc:
+        sostituisce bucket e albero con 'buckets' bucket vuoti.
+        restituisce -1 (lasciando la classifica invariata) se la memoria e' esaurita
+*/
+static int board_alloc(int buckets)
+{
+    int *tree = calloc(buckets + 1, sizeof(int));
+    lb_entry **head = calloc(buckets, sizeof(lb_entry *));
+    lb_entry **tail = calloc(buckets, sizeof(lb_entry *));
+    if (!tree || !head || !tail)
+    {
+        free(tree);
+        free(head);
+        free(tail);
+        return -1;
+    }
+    free(g_board.tree);
+    free(g_board.head);
+    free(g_board.tail);
+    g_board.tree = tree;
+    g_board.head = head;
+    g_board.tail = tail;
+    g_board.buckets = buckets;
+    return 0;
+}
+
+/*
+    board_grow:
+        allarga i bucket fino a contenere 'score' e vi ridistribuisce i giocatori, O(M + n).
+        se la memoria e' esaurita la classifica resta com'e' (bucket_of satura sull'ultimo)
+*/
+static void board_grow(int score)
+{
+    int buckets = g_board.buckets > 0 ? g_board.buckets : 1;
+    while (buckets <= score)
+        buckets *= 2;
+
+    // scollega tutti i giocatori (ordine dei bucket dal basso) e li reinserisce nei nuovi bucket
+    lb_entry *list = NULL;
+    lb_entry **link = &list;
+    for (int b = 0; b < g_board.buckets; b++)
+    {
+        if (g_board.head[b])
+        {
+            *link = g_board.head[b];
+            link = &g_board.tail[b]->next;
+        }
+    }
+    if (board_alloc(buckets) < 0 && g_board.buckets > 0)
+    {
+        // ricostruzione dei bucket esistenti a partire dalla lista
+        memset(g_board.tree, 0, (g_board.buckets + 1) * sizeof(int));
+        memset(g_board.head, 0, g_board.buckets * sizeof(lb_entry *));
+        memset(g_board.tail, 0, g_board.buckets * sizeof(lb_entry *));
+    }
+    lb_entry *next;
+    for (lb_entry *e = list; e; e = next)
+    {
+        next = e->next;
+        bucket_append(e);
+    }
+}
+
+// ======================= API =======================
+
+int leaderboard_reset(int max_score)
+{
+    pthread_mutex_lock(&g_board.mutex);
+    board_free_entries();
+    g_board.count = 0;
+    g_board.version++;
+    int ret = board_alloc((max_score > 0 ? max_score : 0) + 1);
+    if (ret < 0 && g_board.buckets > 0)
+    {
+        // si riusano i bucket della partita precedente
+        memset(g_board.tree, 0, (g_board.buckets + 1) * sizeof(int));
+        memset(g_board.head, 0, g_board.buckets * sizeof(lb_entry *));
+        memset(g_board.tail, 0, g_board.buckets * sizeof(lb_entry *));
+    }
+    pthread_mutex_unlock(&g_board.mutex);
+    return ret;
+}
+
+lb_entry *leaderboard_join(const char *username, int score)
+{
+    lb_entry *e = calloc(1, sizeof(lb_entry));
+    if (!e)
+        return NULL;
+    strncpy(e->username, username, LEADERBOARD_NAME_LEN - 1);
+    e->score = score;
+
+    pthread_mutex_lock(&g_board.mutex);
+    if (score >= g_board.buckets)
+        board_grow(score);
+    if (g_board.buckets == 0)
+    {
+        pthread_mutex_unlock(&g_board.mutex);
+        free(e);
+        return NULL;
+    }
+    bucket_append(e);
+    e->all_next = g_board.all;
+    g_board.all = e;
+    g_board.count++;
+    g_board.version++;
+    pthread_mutex_unlock(&g_board.mutex);
+    return e;
+}
+
+void leaderboard_add(lb_entry *e, int points)
+{
+    if (points == 0)
+        return;
+    pthread_mutex_lock(&g_board.mutex);
+    bucket_unlink(e);
+    e->score += points;
+    if (e->score >= g_board.buckets)
+        board_grow(e->score);
+    bucket_append(e);
+    g_board.version++;
+    pthread_mutex_unlock(&g_board.mutex);
+}
+
+void leaderboard_detach(lb_entry *e, lb_player_state state)
+{
+    unsigned int b = detached_bucket(e->username);
+    pthread_mutex_lock(&g_board.mutex);
+    e->state = state;
+    e->detached_next = g_board.detached[b];
+    g_board.detached[b] = e;
+    pthread_mutex_unlock(&g_board.mutex);
+}
+
+lb_entry *leaderboard_rejoin(const char *username, lb_player_state *state)
+{
+    unsigned int b = detached_bucket(username);
+    pthread_mutex_lock(&g_board.mutex);
+    lb_entry *e = NULL;
+    for (lb_entry **link = &g_board.detached[b]; *link; link = &(*link)->detached_next)
+    {
+        if (strcmp((*link)->username, username) == 0)
+        {
+            e = *link;
+            *link = e->detached_next;
+            break;
+        }
+    }
+    if (e)
+    {
+        *state = e->state;
+        state->score = e->score;
+        memset(&e->state, 0, sizeof(e->state));
+        e->detached_next = NULL;
+    }
+    pthread_mutex_unlock(&g_board.mutex);
+    return e;
+}
+
+int leaderboard_rank(const lb_entry *e)
+{
+    pthread_mutex_lock(&g_board.mutex);
+    int rank = 1 + g_board.count - tree_prefix(bucket_of(e->score));
+    pthread_mutex_unlock(&g_board.mutex);
+    return rank;
+}
+
+int leaderboard_count()
+{
+    pthread_mutex_lock(&g_board.mutex);
+    int count = g_board.count;
+    pthread_mutex_unlock(&g_board.mutex);
+    return count;
+}
+
+unsigned long leaderboard_version()
+{
+    pthread_mutex_lock(&g_board.mutex);
+    unsigned long version = g_board.version;
+    pthread_mutex_unlock(&g_board.mutex);
+    return version;
+}
+
+size_t leaderboard_top(int k, char *buf, size_t size)
+{
+    size_t used = 0;
+    buf[0] = '\0';
+    pthread_mutex_lock(&g_board.mutex);
+    int shown = 0;  // giocatori gia' scritti
+    int rank = 1;   // posizione dei giocatori del bucket corrente
+    for (int b = g_board.buckets - 1; b >= 0 && shown < k; b--)
+    {
+        for (lb_entry *e = g_board.head[b]; e && shown < k; e = e->next)
+        {
+            int n = snprintf(buf + used, size - used, "%d %s %d\n", rank, e->username, e->score);
+            if (n < 0 || (size_t)n >= size - used)
+            {
+                buf[used] = '\0';
+                shown = k;
+                break;
+            }
+            used += n;
+            shown++;
+        }
+        rank = shown + 1;
+    }
+    pthread_mutex_unlock(&g_board.mutex);
+    return used;
+}
+
+char *leaderboard_render(size_t *len)
+{
+    pthread_mutex_lock(&g_board.mutex);
+    // nome, separatori e punteggio di ogni giocatore, piu' la riga del vincitore
+    size_t size = (size_t)g_board.count * (LEADERBOARD_NAME_LEN + 16) + LEADERBOARD_NAME_LEN + 16;
+    if (size > LEADERBOARD_RENDER_MAX + 1)
+        size = LEADERBOARD_RENDER_MAX + 1;
+    char *out = malloc(size);
+    if (!out)
+    {
+        pthread_mutex_unlock(&g_board.mutex);
+        return NULL;
+    }
+
+    size_t used = 0;
+    out[0] = '\0';
+    bool first = true;
+    for (int b = g_board.buckets - 1; b >= 0; b--)
+    {
+        for (lb_entry *e = g_board.head[b]; e; e = e->next)
+        {
+            int n = first ? snprintf(out + used, size - used, "Vincitore: %s\n%s, %d", e->username, e->username, e->score)
+                          : snprintf(out + used, size - used, ", %s, %d", e->username, e->score);
+            if (n < 0 || (size_t)n >= size - used)
+            {
+                // limite raggiunto: i giocatori restanti vengono omessi
+                out[used] = '\0';
+                b = -1;
+                break;
+            }
+            used += n;
+            first = false;
+        }
+    }
+    pthread_mutex_unlock(&g_board.mutex);
+    *len = used;
+    return out;
+}
+
+void leaderboard_shutdown()
+{
+    pthread_mutex_lock(&g_board.mutex);
+    board_free_entries();
+    free(g_board.tree);
+    free(g_board.head);
+    free(g_board.tail);
+    g_board.tree = NULL;
+    g_board.head = g_board.tail = NULL;
+    g_board.buckets = 0;
+    g_board.count = 0;
+    pthread_mutex_unlock(&g_board.mutex);
+}
@@ -0,0 +1,128 @@
+/*
+leaderboard.h
+    classifica della partita in corso, aggiornata a ogni parola accettata
+
+    i giocatori sono raggruppati per punteggio in bucket (un bucket per ogni punteggio
+    da 0 al massimo della matrice), ognuno con la lista dei giocatori che hanno quel
+    punteggio in ordine di arrivo. un albero di Fenwick sui bucket conta i giocatori
+    per punteggio:
+        - aggiornamento di un punteggio: O(log M) (M = punteggio massimo della matrice)
+        - posizione di un giocatore: O(log M)
+        - classifica completa: O(M + n), scorrendo i bucket dal punteggio piu' alto
+    a fine partita la classifica e' gia' ordinata e va solo serializzata.
+
+    un giocatore che si disconnette durante la partita resta in classifica con il
+    punteggio raggiunto (leaderboard_detach): se rientra nella stessa partita riprende
+    lo stesso elemento con punteggio e parole gia' proposte (leaderboard_rejoin), senza
+    comparire due volte e senza poter riproporre le stesse parole. gli elementi staccati
+    sono indicizzati per nome in una tabella hash. tutte le funzioni sono thread-safe
+    (mutex interno): vengono chiamate anche sotto state_mutex del client
+    (ordine: state_mutex -> classifica).
+*/
+
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <stddef.h>
+
+#define LEADERBOARD_NAME_LEN 32             // nome giocatore compreso il terminatore
+#define LEADERBOARD_RENDER_MAX (60 * 1024)  // classifica serializzata (entro il payload massimo del client)
+#define LEADERBOARD_DETACHED_BUCKETS 256    // tabella hash dei giocatori disconnessi (potenza di 2)
+
+typedef struct lb_entry lb_entry;
+
+// stato di gioco di un giocatore disconnesso, conservato fino al suo rientro o a fine partita
+// (used_words, used_capacity e used_stamp come in client_info)
+typedef struct
+{
+    int score;
+    unsigned int *used_words;
+    int used_capacity;
+    unsigned int used_stamp;
+} lb_player_state;
+
+/*
+    leaderboard_reset:
+        svuota la classifica per una nuova partita con punteggio massimo 'max_score'
+        (un punteggio superiore allarga i bucket). restituisce 0, -1 se la memoria e' esaurita
+    si assume che:
+        - nessun lb_entry della partita precedente venga piu' usato
+*/
+int leaderboard_reset(int max_score);
+
+/*
+    leaderboard_join:
+        aggiunge alla classifica il giocatore 'username' con punteggio 'score'.
+        restituisce l'elemento da usare per gli aggiornamenti, NULL se la memoria e' esaurita
+*/
+lb_entry *leaderboard_join(const char *username, int score);
+
+/*
+    leaderboard_add:
+        aggiunge 'points' al punteggio del giocatore (va in coda al bucket del nuovo punteggio)
+*/
+void leaderboard_add(lb_entry *e, int points);
+
+/*
+    leaderboard_detach:
+        il giocatore di 'e' si e' disconnesso: resta in classifica e l'elemento conserva
+        used_words, used_capacity e used_stamp di 'state' (ne prende la proprieta'; il
+        punteggio e' quello dell'elemento) finche' lo stesso utente non rientra
+    si assume che:
+        - e non sia gia' staccato
+*/
+void leaderboard_detach(lb_entry *e, lb_player_state state);
+
+/*
+    leaderboard_rejoin:
+        se 'username' si e' disconnesso durante la partita in corso ne riattacca l'elemento,
+        restituendolo, e copia in *state punteggio e parole proposte (la proprieta' di
+        used_words passa al chiamante). restituisce NULL se il giocatore non e' in classifica
+*/
+lb_entry *leaderboard_rejoin(const char *username, lb_player_state *state);
+
+/*
+    leaderboard_rank:
+        posizione del giocatore (1 = primo): 1 + giocatori con punteggio strettamente maggiore
+*/
+int leaderboard_rank(const lb_entry *e);
+
+/*
+    leaderboard_count:
+        numero di giocatori in classifica
+*/
+int leaderboard_count();
+
+/*
+    leaderboard_version:
+        contatore delle modifiche alla classifica (reset, nuovi giocatori, punti):
+        se non cambia tra due letture la classifica e' rimasta uguale
+*/
+unsigned long leaderboard_version();
+
+/*
+    leaderboard_top:
+        scrive in buf i primi k giocatori, una riga "posizione nome punti" per giocatore
+        (a parita' di punti stessa posizione), troncando a righe intere se buf e' troppo piccolo.
+        restituisce la lunghezza della stringa scritta
+    si assume che:
+        - size > 0
+*/
+size_t leaderboard_top(int k, char *buf, size_t size);
+
+/*
+    leaderboard_render:
+        classifica nel formato di MSG_PUNTI_FINALI: "Vincitore: nome\n" seguito da
+        "nome, punti, nome, punti" in ordine decrescente, al piu' LEADERBOARD_RENDER_MAX byte
+        (i giocatori oltre il limite vengono omessi). restituisce la stringa (malloc,
+        liberata dal chiamante) e in *len la sua lunghezza, NULL se la memoria e' esaurita
+*/
+char *leaderboard_render(size_t *len);
+
+/*
+    leaderboard_shutdown:
+        libera la classifica
+*/
+void leaderboard_shutdown();
+
+#endif // LEADERBOARD_H
@@ -7,10 +7,10 @@ static const char *LETTERS[] = {
 
 static int LETTERS_COUNT = 21;
 
-void generate_matrix(char matrix[16][5], unsigned int seed)
+void generate_matrix(char matrix[][5], int dim, unsigned int seed)
 {
     srand(seed); // Usa il seed passato dal server
-    for (int i = 0; i < 16; i++)
+    for (int i = 0; i < dim * dim; i++)
     {
         int idx = rand() % LETTERS_COUNT;
         strncpy(matrix[i], LETTERS[idx], 4);
@@ -18,164 +18,66 @@ void generate_matrix(char matrix[16][5], unsigned int seed)
     }
 }
 
-int count_letters(const char *word)
-{
-
-    int count = 0;
-    for (int i = 0; word[i]; i++)
-    {
-        char c = (char)toupper((unsigned char)word[i]);
-        if (c == 'Q')
-        {
-            char c2 = (char)toupper((unsigned char)word[i + 1]);
-            if (c2 == 'U')
-            {
-                count++;
-                i++; // skip u
-                continue;
-            }
-        }
-        count++;
-    }
-    return count;
-}
+// ======================= rappresentazione compatta =======================
 
 /*
-    tokenize_word:
-        Tokenizza una parola in modo che 'qu' diventi un singolo token.
-        Si assume che 'word' sia una stringa valida terminata da '\0'.
-        Restituisce il numero di token trovati.
- */
-int tokenize_word(const char *word, char tokens[][3])
+    tabelle dei vicini generate a compile time: CELL_BIT vale il bit della cella (r, c)
+    se interna alla griglia d x d, 0 altrimenti (il ramo non valutato del ternario evita
+    shift negativi), NEIGHBORS(d, i) somma gli 8 possibili vicini della cella i.
+*/
+#define CELL_BIT(d, r, c) (((r) >= 0 && (r) < (d) && (c) >= 0 && (c) < (d)) ? ((board_mask)1 << ((r) * (d) + (c))) : 0)
+#define NEIGHBORS(d, i) (CELL_BIT(d, (i) / (d) - 1, (i) % (d) - 1) | CELL_BIT(d, (i) / (d) - 1, (i) % (d)) |     \
+                         CELL_BIT(d, (i) / (d) - 1, (i) % (d) + 1) | CELL_BIT(d, (i) / (d), (i) % (d) - 1) |     \
+                         CELL_BIT(d, (i) / (d), (i) % (d) + 1) | CELL_BIT(d, (i) / (d) + 1, (i) % (d) - 1) |     \
+                         CELL_BIT(d, (i) / (d) + 1, (i) % (d)) | CELL_BIT(d, (i) / (d) + 1, (i) % (d) + 1))
+
+#define NEIGHBORS_ROW(d, r) NEIGHBORS(d, (r) * (d) + 0), NEIGHBORS(d, (r) * (d) + 1), NEIGHBORS(d, (r) * (d) + 2), \
+                            NEIGHBORS(d, (r) * (d) + 3)
+#define NEIGHBORS_ROW5(d, r) NEIGHBORS_ROW(d, r), NEIGHBORS(d, (r) * (d) + 4)
+#define NEIGHBORS_ROW6(d, r) NEIGHBORS_ROW5(d, r), NEIGHBORS(d, (r) * (d) + 5)
+
+static const board_mask NEIGHBORS_4[16] = {
+    NEIGHBORS_ROW(4, 0), NEIGHBORS_ROW(4, 1), NEIGHBORS_ROW(4, 2), NEIGHBORS_ROW(4, 3)};
+
+static const board_mask NEIGHBORS_5[25] = {
+    NEIGHBORS_ROW5(5, 0), NEIGHBORS_ROW5(5, 1), NEIGHBORS_ROW5(5, 2), NEIGHBORS_ROW5(5, 3),
+    NEIGHBORS_ROW5(5, 4)};
+
+static const board_mask NEIGHBORS_6[36] = {
+    NEIGHBORS_ROW6(6, 0), NEIGHBORS_ROW6(6, 1), NEIGHBORS_ROW6(6, 2), NEIGHBORS_ROW6(6, 3),
+    NEIGHBORS_ROW6(6, 4), NEIGHBORS_ROW6(6, 5)};
+
+const board_mask *board_neighbors(int dim)
 {
-    int tcount = 0;
-    int i = 0;
-    while (word[i])
+    switch (dim)
     {
-        char c = (char)toupper((unsigned char)word[i]);
-        // Se c='Q' e c2='U', gestiamo "QU" come un unico token
-        if (c == 'Q')
-        {
-            char c2 = (char)toupper((unsigned char)word[i + 1]);
-            if (c2 == 'U')
-            {
-                strcpy(tokens[tcount], "QU");
-                tcount++;
-                i += 2; // salta u
-                continue;
-            }
-        }
-        // altrimenti (c != 'q') prendiamo singolo carattere
-        tokens[tcount][0] = c;
-        tokens[tcount][1] = '\0';
-        tcount++;
-        i++;
+    case 4:
+        return NEIGHBORS_4;
+    case 5:
+        return NEIGHBORS_5;
+    case 6:
+        return NEIGHBORS_6;
+    default:
+        return NULL;
     }
-    return tcount;
 }
 
-/*
-    dfs_find:
-      Cerca ricorsivamente nella matrice, a partire dalla cella 'index',
-      se è possibile formare la sequenza tokens[pos..].
-        - Se tokens[pos] non coincide con matrix[index], restituisce false.
-        - Altrimenti, se pos è l’ultimo token, restituisce true.
-        - Altrimenti prova ad andare in tutte le 8 direzioni (verticali, orizzontali, diagonali).
-        - Usa l’array visted[] per non riusare la stessa cella più di una volta nella parola.
-
-    si assume che:
-        - matrix sia una matrice 4x4 di stringhe valide
-        - tokens sia un array di token validi
-        - pos sia l'indice del token corrente
-        - total sia il numero totale di token
-        - index sia l'indice della cella corrente
- */
-bool dfs_find(char matrix[16][5], char tokens[][3], int pos, int total, int index, bool visted[16])
+void encode_board(char matrix[][5], int dim, encoded_board *board)
 {
-    // se abbiamo gia' matchato tutti i token (pos == total)
-    if (pos == total)
-        return true; // parola trovata
-
-    // matrix[index] deve matchare con tokens[pos]. confronto case-insensitive
-    if (strcasecmp(matrix[index], tokens[pos]) != 0)
+    board->dim = dim;
+    board->cell_count = dim * dim;
+    board->neighbors = board_neighbors(dim);
+    memset(board->letter_mask, 0, sizeof(board->letter_mask));
+    for (int i = 0; i < board->cell_count; i++)
     {
-        return false;
+        char c = (char)tolower((unsigned char)matrix[i][0]);
+        uint8_t code = BOARD_NO_LETTER;
+        if (c == 'q' && tolower((unsigned char)matrix[i][1]) == 'u')
+            code = 26;
+        else if (c >= 'a' && c <= 'z')
+            code = (uint8_t)(c - 'a');
+        board->cells[i] = code;
+        if (code != BOARD_NO_LETTER)
+            board->letter_mask[code] |= (board_mask)1 << i;
     }
-
-    // marca cella visistata
-    visted[index] = true;
-
-    // controllo ultimo token
-    if (pos == total - 1)
-    {
-        visted[index] = false;
-        return true;
-    }
-
-    // coordinate
-    int row = index / 4;
-    int col = index % 4;
-
-    // offset 8 direzioni
-    static int dr[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
-    static int dc[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
-
-    bool found = false;
-    for (int i = 0; i < 8 && !found; i++)
-    {
-        int rr = row + dr[i];
-        int cc = col + dc[i];
-        if (rr < 0 || rr >= 4 || cc < 0 || cc >= 4) // esclude fuori dalla matrice
-            continue;
-        int new_index = rr * 4 + cc;
-        // se la cella adiacente non e' ancora usata
-        if (!visted[new_index])
-        {
-            // ricorsiva sul token successivo
-            if (dfs_find(matrix, tokens, pos + 1, total, new_index, visted))
-            {
-                found = true;
-            }
-        }
-    }
-
-    // rimozione segno sulla cella
-    visted[index] = false;
-    return found;
 }
-
-/*
-    is_word_in_matrix:
-        Verifica se una data parola è "componibile" dalla matrice di lettere.
-        - Tokenizza la parola in modo che 'qu' diventi un singolo token.
-        - Richiede che la parola abbia almeno 4 caratteri logici (tcount >= 4).
-        - Usa la dfs_find() a partire da ognuna delle 16 celle, finché non trova un match o esaurisce tutte le possibilità.
- */
-bool is_word_in_matrix(char matrix[16][5], const char *word)
-{
-    char tokens[32][3];
-    memset(tokens, 0, sizeof(tokens));
-    int tcount = tokenize_word(word, tokens);
-    bool visted[16] = {false};
-
-    if (word == NULL || strlen(word) == 0)
-    {
-        return false;
-    }
-
-    // controlla almeno 4 lettere
-    if (tcount < 4)
-    {
-        return false;
-    }
-    // dfs partendo da ognuno dei 16 slot
-    for (int i = 0; i < 16; i++)
-    {
-        if (dfs_find(matrix, tokens, 0, tcount, i, visted))
-        {
-            return true; // parola trovata
-        }
-    }
-    // parola non presente in matrice
-    return false;
-}
\ No newline at end of file
@@ -8,26 +8,54 @@
 #include <stdbool.h>
 #include <ctype.h>
 #include <strings.h>
+#include <stdint.h>
+
+#define BOARD_MIN_DIM 4
+#define BOARD_MAX_DIM 6
+#define BOARD_MAX_CELLS (BOARD_MAX_DIM * BOARD_MAX_DIM)
+#define BOARD_LETTER_CODES 27   // 0..25 = 'a'..'z', 26 = "qu" (stessi indici del dizionario)
+#define BOARD_NO_LETTER 0xff    // cella che non contiene una lettera
+
+// insieme di celle: bit i = cella i (righe concatenate), basta per la griglia 6x6
+typedef uint64_t board_mask;
 
 /*
-    generate_matrix:
-        Genera una matrice 4x4 di lettere casuali(2 caratteri utili + 1 per il terminatore).
-        Si assume che 'matrix' sia un array di 16 stringhe da 3 char ciascuna.
+    encoded_board:
+        rappresentazione compatta della matrice, affiancata a char matrix[][5]:
+        ogni cella e' un codice lettera e, per ogni codice, una maschera indica le
+        celle che lo contengono. insieme alla tabella dei vicini della dimensione
+        scelta (generata a compile time per 4x4, 5x5 e 6x6) e ad un insieme di
+        celle visitate, l'estensione di un cammino si riduce a:
+        vicini & celle_con_lettera & ~visitate.
 */
-void generate_matrix(char matrix[16][5], unsigned int seed);
+typedef struct
+{
+    int dim;                     // lato della griglia (BOARD_MIN_DIM..BOARD_MAX_DIM)
+    int cell_count;              // dim * dim
+    const board_mask *neighbors; // neighbors[i]: celle adiacenti alla cella i
+    uint8_t cells[BOARD_MAX_CELLS];
+    board_mask letter_mask[BOARD_LETTER_CODES];
+} encoded_board;
 
 /*
-    count_letters:
-        Conta i caratteri "logici" di una parola, considerando "Qu" come un singolo carattere.
-        Si assume che 'word' sia una stringa valida terminata da '\0'.
+    board_neighbors:
+        Restituisce la tabella dei vicini per una griglia dim x dim, NULL se la dimensione
+        non e' supportata.
+*/
+const board_mask *board_neighbors(int dim);
+
+/*
+    generate_matrix:
+        Genera una matrice dim x dim di lettere casuali (al piu' 4 caratteri utili + terminatore).
+        Si assume che 'matrix' abbia almeno dim * dim celle e che dim sia supportata.
 */
-int count_letters(const char *word);
+void generate_matrix(char matrix[][5], int dim, unsigned int seed);
 
 /*
-    is_word_in_matrix:
-        Verifica se una data parola può essere formata dalla matrice.
-        Si assume che 'matrix' contenga 16 stringhe valide e 'word' sia una stringa valida.
+    encode_board:
+        Costruisce la rappresentazione compatta di 'matrix'.
+        Si assume che 'matrix' contenga dim * dim stringhe valide e che dim sia supportata.
 */
-bool is_word_in_matrix(char matrix[16][5], const char *word);
+void encode_board(char matrix[][5], int dim, encoded_board *board);
 
 #endif // MATRIX_H
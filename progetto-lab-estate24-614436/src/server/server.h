@@ -4,6 +4,14 @@
 #define _GNU_SOURCE // soluzione per errore implicit declaration of signal.h
 
 #include "common/common.h"
+#include "server/matrix.h"
+#include "server/workpool.h"
+#include "server/snapshot.h"
+#include "server/frame.h"
+#include "server/userstore.h"
+#include "server/leaderboard.h"
+#include "server/asynclog.h"
+#include "server/eventlog.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -20,13 +28,46 @@
 #include <unistd.h>
 #include <time.h>
 #include <getopt.h>
-
-#define MAX_CLIENTS 32
-#define USERNAME_LEN 32
-#define MAX_WORDS_USED 256
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+
+#define DEFAULT_MAX_CLIENTS 32 // connessioni contemporanee di default (--max-client)
+#define USERNAME_LEN USERSTORE_NAME_LEN
 #define MAX_BACHECA_MSG 8
-#define MAX_REGISTERED_USERS 1000
-#define MAX_SCORE_MSG MAX_CLIENTS
+#define DEFAULT_DICT_FILE "resources/dictionary.txt"
+#define LOG_FILE "paroliere.log"
+#define CLIENT_OUT_MAX (1024 * 1024)       // modalita' epoll: dati in attesa oltre i quali il client e' troppo lento
+#define CLIENT_SEND_TIMEOUT 2              // modalita' thread: secondi di invio bloccato oltre i quali il client e' troppo lento
+#define REACTOR_MAX_EVENTS 256
+#define CLIENT_IN_MAX_PAYLOAD MSG_PAROLE_MAX // payload piu' lungo accettato da un client (un batch MSG_PAROLE)
+#define LIVE_TOP_K 5      // giocatori nella classifica parziale (MSG_CLASSIFICA_LIVE)
+#define LIVE_TICK_MS 250  // intervallo minimo tra due invii della classifica parziale
+#define LIVE_TOP_MAX 512  // dimensione massima del messaggio di classifica parziale
+#define SESSION_STRIPES 16 // lock della mappa username -> client (ognuno protegge un bucket ogni SESSION_STRIPES)
+
+// livelli di verbosita' della console (--verbosita, SIGUSR1/SIGUSR2 a runtime)
+#define CONSOLE_OFF 0
+#define CONSOLE_INFO 1  // avvio e shutdown, connessioni, inizio e fine partita
+#define CONSOLE_DEBUG 2 // ogni richiesta dei client
+#ifndef CONSOLE_MAX_LEVEL
+#define CONSOLE_MAX_LEVEL CONSOLE_DEBUG // livello piu' alto compilato (es. -DCONSOLE_MAX_LEVEL=CONSOLE_INFO)
+#endif
+
+/*
+    console_printf:
+        scrive sulla console (safe_printf) se 'level' e' attivo: il controllo e' una lettura
+        atomica di console_level, gli argomenti non vengono valutati se il livello e' spento;
+        i livelli oltre CONSOLE_MAX_LEVEL vengono eliminati in compilazione
+*/
+#define console_printf(level, ...)                                                                       \
+    do                                                                                                   \
+    {                                                                                                    \
+        if ((level) <= CONSOLE_MAX_LEVEL && (level) <= __atomic_load_n(&console_level, __ATOMIC_RELAXED)) \
+            safe_printf(__VA_ARGS__);                                                                    \
+    } while (0)
 
 // ======================= API server =======================
 
@@ -37,46 +78,96 @@ int server_init(
     const char *dict_filename,
     const char *matrix_filename,
     int seed,
-    int disconnect_after_sec);
+    int disconnect_after_sec,
+    bool dict_dawg,
+    int board_dim,
+    bool use_epoll,
+    int workers,
+    int max_clients,
+    const char *users_file);
 int server_run();
 void server_shutdown();
 void server_set_name(const char *name);
+void server_set_verbosity(int level);
+
+extern int console_level;
+void safe_printf(const char *format, ...);
 
 typedef struct trie_node trie_node;
 void *load_dictionary_trie(const char *filename);
+void *load_dictionary_dawg(const char *filename);
+bool dictionary_is_image(const char *filename);
+void *load_dictionary_image(const char *filename);
+int save_dictionary_image(const trie_node *dict, const char *filename);
 bool trie_search(trie_node *root, const char *word);
 void trie_free(trie_node *node);
 
-void generate_matrix(char matrix[16][5], unsigned int seed);
-bool is_word_in_matrix(char matrix[16][5], const char *word);
-int count_letters(const char *word);
+typedef struct solved_board solved_board;
+solved_board *solve_board(const encoded_board *board, const trie_node *dict);
+int solved_board_find(const solved_board *sb, const char *word, int *points);
+int solved_board_count(const solved_board *sb);
+int solved_board_max_score(const solved_board *sb);
+void solved_board_free(solved_board *sb);
+
 
 // ======================= strutture dati =======================
 
 // struttura per gestione un client
-typedef struct
+// i record sono allocati alla prima connessione nello slot e riusati, mai spostati
+typedef struct client_info
 {
+    int idx; // posizione nella tabella g_server.clients
     int sockfd;
     bool connected;
     char username[USERNAME_LEN];
+    // stato di gioco del client: score, used_words, rank_entry, in_game (protetti da state_mutex)
+    pthread_mutex_t state_mutex;
     int score;
 
-    // parole gia' proposte da client
-    char used_words[MAX_WORDS_USED][32];
-    int used_words_count;
+    // parole gia' proposte nella partita, indicizzate per indice della parola in solved_board:
+    // la parola id e' stata proposta se used_words[id] == used_stamp.
+    // incrementare used_stamp svuota l'insieme in O(1) (client_clear_words_locked)
+    unsigned int *used_words;
+    int used_capacity;
+    unsigned int used_stamp;
 
-    bool score_sent;
-    pthread_t thread_id;
+    lb_entry *rank_entry; // posizione in classifica nella partita in corso, NULL se non partecipa
+    pthread_t thread_id; // solo in modalita' thread-per-client
 
     bool in_game;
+    unsigned int conn_id; // incrementato a ogni nuova connessione nello slot (scarta risposte di job vecchi)
+
+    // serializza gli invii verso il client (gestore, orchestrator e scorer possono scrivere insieme)
+    // e protegge sockfd (-1 se il socket e' chiuso) e i buffer sottostanti
+    pthread_mutex_t out_mutex;
+
+    // frame ricevuti (usato solo dal thread del client o dal reactor)
+    msg_reader reader;
+
+    // modalita' epoll: dati non ancora accettati dal socket
+    char *out_buf;
+    size_t out_len;
+    size_t out_capacity;
+    bool want_write; // EPOLLOUT registrato
+    bool out_overflow; // client troppo lento: epoll, lo chiude il reactor; thread, socket gia' chiuso con shutdown
+    time_t last_activity;
+
+    // lista dei client connessi (protetta da clients_mutex)
+    struct client_info *next_active;
+    struct client_info *prev_active;
+    int next_free; // slot libero successivo, se il record e' nella lista dei liberi
+
+    // catena del bucket nella mappa delle sessioni (protetta dal lock di stripe del bucket)
+    struct client_info *next_session;
 } client_info;
 
-// struttura per gestione registrazion utenti
+// riferimento ad un client copiato sotto clients_mutex, per inviare senza lock globali
 typedef struct
 {
-    char username[USERNAME_LEN];
-    bool deleted;
-} RegisteredUser;
+    int idx;
+    unsigned int conn_id;
+    bool logged_in;
+} client_ref;
 
 // struttura per gestione bacheca (coda circolare)
 typedef struct
@@ -92,39 +183,33 @@ typedef struct
     int count;
 } Bacheca;
 
-// struttura per messaggi di punteggio
-typedef struct
-{
-    char username[USERNAME_LEN];
-    int score;
-} ScoreMsg;
-
-// coda dei punteggi: conterra' i punteggi finali inviati dai client
-typedef struct
-{
-    ScoreMsg messages[MAX_SCORE_MSG];
-    int count;
-    int expected;
-} scoreQueue;
-
 // server globale
 typedef struct
 {
     int port;
     int server_sockfd; // socket di ascolto per nuove connesioni
-    client_info clients[MAX_CLIENTS];
-    pthread_mutex_t clients_mutex;
-
-    // matrice di gioco
-    char matrix[16][5];
+    // tabella dei client: max_clients puntatori, i record sono allocati solo per gli slot usati
+    client_info **clients;
+    int max_clients;
+    int client_slots;          // record allocati (clients[0..client_slots-1])
+    int free_slot;             // primo slot libero da riusare, -1 se nessuno
+    client_info *active_head;  // client connessi
+    int active_count;
+    pthread_mutex_t clients_mutex; // lista/tabella dei client, username (scritto anche sotto il lock di sessione)
+    // modalita' thread per client: thread dei client ancora attivi (protetto da clients_mutex);
+    // lo shutdown attende client_threads_cond con client_threads == 0 prima di liberare i record
+    int client_threads;
+    pthread_cond_t client_threads_cond;
+
+    // stato della partita (matrice, parole valide, fase e tempi): pubblicato dall'orchestrator
+    // come snapshot immutabile (vedi snapshot.h), letto senza lock con snapshot_enter/snapshot_exit.
+    // ordine dei lock: clients_mutex -> registered_mutex -> session_locks -> state_mutex -> out_mutex
+    int board_dim; // lato della griglia (4, 5 o 6)
     int seed;
 
-    // parametri/ stato della partita
-    bool game_running;      // true se partita in corso
-    time_t game_start_time; // orario inizio partita
+    // parametri della partita
     int game_duration;      // durata partita in secondi
     int break_time;         // pausa tra partite in secondi
-    time_t break_start_time;
 
     // dizionario caricato in trie
     void *dictionary;
@@ -133,26 +218,37 @@ typedef struct
 
     // thread orchestratore per cicolo partita/pausa
     pthread_t orchestrator_thread_id;
+    int phase_timer_fd; // timerfd armato alla scadenza della fase corrente (partita o pausa)
+    int stop_event_fd;  // eventfd scritto allo shutdown, risveglia l'orchestrator in attesa
+    int live_timer_fd;  // timerfd periodico (LIVE_TICK_MS) della classifica parziale, attivo solo in partita
+    int verbosity_event_fd; // eventfd scritto da SIGUSR1/SIGUSR2, l'orchestrator registra il nuovo livello
     // trhead scorer per gestione classifica
     pthread_t scorer_thread_id;
 
     int disconnect_timeout; // timeout per inattivita' del client (sec)
 
+    // modalita' epoll: un unico thread (reactor) gestisce tutte le connessioni
+    bool use_epoll;
+    int epoll_fd;
+
+    int workers; // thread del pool di verifica parole, 0 = verifica nel thread di I/O
+
     // se specificato, file contenente matrice di gioco
     char *matrix_filename;
     FILE *matrix_fp;
 
-    // log file e mutex dedicato
-    FILE *log_fp;
-    pthread_mutex_t log_mutex;
-
     // server name
     char server_name[128];
 
-    // utenti registrati
-    RegisteredUser registered_users[MAX_REGISTERED_USERS];
-    int registered_count;
+    // utenti registrati: archivio in userstore.c (tabella hash + journal), protetto da registered_mutex
     pthread_mutex_t registered_mutex;
+
+    // sessioni: username -> client autenticato, tabella hash a catene intrusive (next_session).
+    // session_buckets e' una potenza di 2, il bucket b e' protetto da session_locks[b % SESSION_STRIPES]:
+    // login e controlli "gia' connesso" non serializzano sulla lista dei client
+    client_info **sessions;
+    unsigned int session_buckets;
+    pthread_mutex_t session_locks[SESSION_STRIPES];
 } server_paroliere;
 
 #endif // SERVER_H
@@ -6,7 +6,10 @@ funzione main del sever "Paroliere"
 sintassi: Sintassi:
  *   ./paroliere_srv nome_server porta_server [--matrici data_filename]
  *                   [--durata durata_in_minuti] [--seed rnd_seed]
- *                   [--diz dizionario] [--disconnetti-dopo minuti]
+ *                   [--diz dizionario] [--disconnetti-dopo minuti] [--dawg]
+ *                   [--dimensione lato] [--epoll] [--worker n] [--max-client n]
+ *                   [--utenti journal] [--verbosita off|info|debug]
+ *   ./paroliere_srv nome_server porta_server [--diz dizionario] [--dawg] --diz-compile immagine
  *
  *  Opzioni:
      - nome_server: è un parametro formale (il server di fatto ascolta su INADDR_ANY),
@@ -17,8 +20,24 @@ sintassi: Sintassi:
      - --durata <minuti>: durata di una singola partita (default 3 minuti).
      - --seed <rnd_seed>: seed per la generazione pseudo-casuale della matrice
        (se non specificato, usa time(NULL)).
-     - --diz <dizionario>: percorso file dizionario (default: "dictionary.txt").
+     - --diz <dizionario>: percorso file dizionario (default: "dictionary.txt"), testo
+       oppure immagine binaria prodotta da --diz-compile (riconosciuta automaticamente).
      - --disconnetti-dopo <minuti>: tempo di inattività prima di disconnettere un client (default: 3 minuti).
+     - --dawg: carica il dizionario in un DAWG minimo (suffissi condivisi) invece che in un trie.
+     - --dimensione <lato>: lato della griglia, 4 (default), 5 o 6 ("Big Boggle").
+       con --matrici, ogni riga del file deve contenere lato * lato celle.
+     - --epoll: gestisce tutte le connessioni con un unico thread (reactor epoll)
+       invece che con un thread per client.
+     - --worker <n>: numero di thread che verificano le parole proposte
+       (default: numero di core disponibili, 0 = verifica nel thread della connessione).
+     - --max-client <n>: numero massimo di client connessi contemporaneamente (default 32).
+     - --utenti <journal>: file in cui vengono salvati gli utenti registrati, riletto
+       all'avvio (default: "paroliere_utenti.journal").
+     - --verbosita <livello>: messaggi sulla console: off (nessuno), info (avvio, connessioni,
+       partite; default) o debug (anche ogni richiesta dei client). a server avviato
+       SIGUSR1 aumenta e SIGUSR2 diminuisce il livello.
+     - --diz-compile <immagine>: costruisce il dizionario, lo salva come immagine binaria
+       in <immagine> e termina senza avviare il server.
 
     si assume che:
         - argv sia un array di stringhe non NULL
@@ -34,7 +53,7 @@ int main(int argc, char *argv[])
     // verfica presenza parametri obbligatori : nome_server e porta
     if (argc < 3)
     {
-        fprintf(stderr, "Uso corretto: %s <nome_server> <porta> [--matrici file] [--durata minuti] [--seed rnd_seed] [--diz dizionario] [--disconnetti-dopo minuti]\n",
+        fprintf(stderr, "Uso corretto: %s <nome_server> <porta> [--matrici file] [--durata minuti] [--seed rnd_seed] [--diz dizionario] [--disconnetti-dopo minuti] [--dawg] [--dimensione lato] [--epoll] [--worker n] [--max-client n] [--utenti journal] [--verbosita off|info|debug] [--diz-compile immagine]\n",
                 argv[0]);
         return 1;
     }
@@ -58,6 +77,14 @@ int main(int argc, char *argv[])
     const char *matrix_filename = NULL; // se non viene fornita, matrice generata casualmente
     int seed = -1;                      // se -1, si usa time(NULL) come seed
     int disconnect_min = 3;             // timeout inattivita' di default : 3 minuti
+    bool dict_dawg = false;             // se true, dizionario caricato come DAWG
+    const char *compile_filename = NULL; // se specificato, salva l'immagine del dizionario ed esce
+    int board_dim = 4;                  // lato della griglia di default : 4x4
+    bool use_epoll = false;             // se true, connessioni gestite dal reactor epoll
+    int workers = (int)sysconf(_SC_NPROCESSORS_ONLN); // worker per la verifica parole : uno per core
+    int max_clients = DEFAULT_MAX_CLIENTS;             // connessioni contemporanee
+    const char *users_filename = DEFAULT_USERS_FILE;   // journal degli utenti registrati
+    int verbosity = CONSOLE_INFO;                       // messaggi sulla console
 
     // parsint parametri
     // gestione argomenti opzionali passati tramite getopt_long
@@ -70,9 +97,17 @@ int main(int argc, char *argv[])
         {"seed", required_argument, 0, 's'},
         {"diz", required_argument, 0, 'z'},
         {"disconnetti-dopo", required_argument, 0, 't'},
+        {"dawg", no_argument, 0, 'g'},
+        {"diz-compile", required_argument, 0, 'c'},
+        {"dimensione", required_argument, 0, 'n'},
+        {"epoll", no_argument, 0, 'e'},
+        {"worker", required_argument, 0, 'w'},
+        {"max-client", required_argument, 0, 'k'},
+        {"utenti", required_argument, 0, 'u'},
+        {"verbosita", required_argument, 0, 'v'},
         {0, 0, 0, 0}};
 
-    while ((opt = getopt_long(argc, argv, "m:d:s:z:x:t:", long_options, &option_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "m:d:s:z:x:t:gc:n:ew:k:u:v:", long_options, &option_index)) != -1)
     {
         switch (opt)
         {
@@ -101,8 +136,57 @@ int main(int argc, char *argv[])
                 exit(EXIT_FAILURE);
             }
             break;
+        case 'g':
+            dict_dawg = true;
+            break;
+        case 'c':
+            compile_filename = optarg;
+            break;
+        case 'e':
+            use_epoll = true;
+            break;
+        case 'w':
+            workers = atoi(optarg);
+            if (workers < 0)
+            {
+                fprintf(stderr, "[ERROR] Il numero di worker non puo' essere negativo\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'k':
+            max_clients = atoi(optarg);
+            if (max_clients <= 0)
+            {
+                fprintf(stderr, "[ERROR] Il numero massimo di client deve essere maggiore di 0\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'u':
+            users_filename = optarg;
+            break;
+        case 'v':
+            if (strcmp(optarg, "off") == 0)
+                verbosity = CONSOLE_OFF;
+            else if (strcmp(optarg, "info") == 0)
+                verbosity = CONSOLE_INFO;
+            else if (strcmp(optarg, "debug") == 0)
+                verbosity = CONSOLE_DEBUG;
+            else
+            {
+                fprintf(stderr, "[ERROR] Verbosita' non valida: %s (off, info o debug)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'n':
+            board_dim = atoi(optarg);
+            if (board_dim < BOARD_MIN_DIM || board_dim > BOARD_MAX_DIM)
+            {
+                fprintf(stderr, "[ERROR] La dimensione della griglia deve essere compresa tra %d e %d\n", BOARD_MIN_DIM, BOARD_MAX_DIM);
+                exit(EXIT_FAILURE);
+            }
+            break;
         default:
-            fprintf(stderr, "Uso corretto: %s <nome_server> <porta> [--matrici file] [--durata minuti] [--seed rnd_seed] [--diz dizionario] [--disconnetti-dopo minuti]\n",
+            fprintf(stderr, "Uso corretto: %s <nome_server> <porta> [--matrici file] [--durata minuti] [--seed rnd_seed] [--diz dizionario] [--disconnetti-dopo minuti] [--dawg] [--dimensione lato] [--epoll] [--worker n] [--max-client n] [--utenti journal] [--verbosita off|info|debug] [--diz-compile immagine]\n",
                     argv[0]);
             exit(EXIT_FAILURE);
         }
@@ -114,13 +198,31 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
+    // modalita' di compilazione del dizionario: nessun server avviato
+    if (compile_filename != NULL)
+    {
+        if (dict_filename == NULL)
+            dict_filename = DEFAULT_DICT_FILE;
+        trie_node *dict = dict_dawg ? load_dictionary_dawg(dict_filename) : load_dictionary_trie(dict_filename);
+        if (dict == NULL || save_dictionary_image(dict, compile_filename) < 0)
+        {
+            fprintf(stderr, "[ERROR] Impossibile compilare il dizionario %s in %s\n", dict_filename, compile_filename);
+            trie_free(dict);
+            exit(EXIT_FAILURE);
+        }
+        trie_free(dict);
+        printf("Dizionario %s compilato in %s (%s)\n", dict_filename, compile_filename, dict_dawg ? "DAWG" : "trie");
+        return 0;
+    }
+
     // convesioni in secondi
     int game_duration_sec = durata_min * 60;
     int break_time_sec = break_min * 60;
     int disconnect_after_sec = disconnect_min * 60;
 
     // inizializzazione server
-    if (server_init(port, game_duration_sec, break_time_sec, dict_filename, matrix_filename, seed, disconnect_after_sec) < 0)
+    server_set_verbosity(verbosity);
+    if (server_init(port, game_duration_sec, break_time_sec, dict_filename, matrix_filename, seed, disconnect_after_sec, dict_dawg, board_dim, use_epoll, workers, max_clients, users_filename) < 0)
     {
         fprintf(stderr, "Errore inizializzazione server\n");
         exit(EXIT_FAILURE);
@@ -13,22 +13,22 @@ static server_paroliere g_server;
 static Bacheca bacheca = {.front = 0, .count = 0};
 static pthread_mutex_t bacheca_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-// coda dei punteggi
-scoreQueue g_score_queue = {.count = 0, .expected = 0};
-pthread_mutex_t score_queue_mutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_cond_t score_queue_cond = PTHREAD_COND_INITIALIZER;
-
-// per sincronizzazione dell'invio di classifica
+// per sincronizzazione dell'invio di classifica: l'orchestrator richiede la classifica
+// a fine partita (ranking_requested), lo scorer la invia e lo segnala (ranking_sent)
+bool ranking_requested = false;
 bool ranking_sent = false;
 pthread_mutex_t ranking_mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t ranking_cond = PTHREAD_COND_INITIALIZER;
 
-// Definizione e inizializzazione di un mutex globale per l'output della console
-pthread_mutex_t server_console_mutex = PTHREAD_MUTEX_INITIALIZER;
+// livello di verbosita' della console (CONSOLE_*), letto e modificato con operazioni atomiche
+int console_level = CONSOLE_INFO;
 
 /*
     safe_printf:
-        funzione thread-safe per scrivere su console, sincronizzazione dell'accesso tramite mutex dedicato
+        funzione thread-safe per scrivere su console: il messaggio viene accodato nel ring del
+        thread chiamante e scritto su stdout dal thread writer del log (asynclog.h), senza lock
+        globali. prima dell'apertura e dopo la chiusura del log scrive direttamente.
+        da usare tramite console_printf, che controlla il livello di verbosita'
     si assume che:
         - format sia una stringa di formato corretta
         - gli argomenti siano corretti
@@ -36,62 +36,45 @@ pthread_mutex_t server_console_mutex = PTHREAD_MUTEX_INITIALIZER;
 void safe_printf(const char *format, ...)
 {
     va_list args;
-    pthread_mutex_lock(&server_console_mutex);
     va_start(args, format);
-    vprintf(format, args);
+    if (!asynclog_console(format, args))
+    {
+        vprintf(format, args);
+        fflush(stdout);
+    }
     va_end(args);
-    pthread_mutex_unlock(&server_console_mutex);
 }
 
 // ======================= logging =======================
 /*
     log_event:
-        registra un evento sul file di log con timestamp
-        utilizza con mutex per garantire l'accesso esclusivo al file di log
+        registra un evento sul file di log: il messaggio viene accodato nel ring del thread
+        chiamante e scritto con il timestamp dal thread writer (asynclog.h), senza lock globali
 
     si assume che:
         - format sia una stringa di formato corretta
         - gli argomenti siano corretti
-        - il file di log sia aperto e valido
 */
 void log_event(const char *format, ...)
 {
-    if (g_server.log_fp == NULL)
-        return;
-
-    pthread_mutex_lock(&g_server.log_mutex);
-
-    // timestamp
-    time_t now = time(NULL);
-    char timestr[64];
-    strftime(timestr, sizeof(timestr), "%Y-%m-%d %H:%M:%S", localtime(&now));
-    fprintf(g_server.log_fp, "[%s] [%s] ", timestr, g_server.server_name);
-
-    // messaggio di log
     va_list args;
     va_start(args, format);
-    vfprintf(g_server.log_fp, format, args);
+    asynclog_vwrite(format, args);
     va_end(args);
-    fprintf(g_server.log_fp, "\n");
-
-    // flush
-    fflush(g_server.log_fp);
-
-    pthread_mutex_unlock(&g_server.log_mutex);
 }
 
 // ======================= lettura matrice da file =======================
 /*
     read_matrix_from_file:
-        se e' specificato un file di matrici, legge una riga e ne estrae 16 token (celle), separati da spazi o tab.
+        se e' specificato un file di matrici, legge una riga e ne estrae board_dim * board_dim token (celle), separati da spazi o tab.
         se si raggiunge la fine del fine, il puntatore viene fatto rewind per ciclare le matrici
         ritorna ture se la lettura ha avuto successo, false altrimenti
 
     si assume che:
         - il file sia aperto e valido e abbia il formato atteso
-        - la matrice sia un array bidimensionale 16x5, dove ogni riga contiene un token di 4 caratteri + terminatore
+        - la matrice sia un array di almeno board_dim * board_dim celle, dove ogni cella contiene un token di 4 caratteri + terminatore
 */
-bool read_matrix_from_file(char matrix[16][5])
+bool read_matrix_from_file(char matrix[][5])
 {
     char line[1024];
     if (fgets(line, sizeof(line), g_server.matrix_fp) == NULL)
@@ -105,9 +88,9 @@ bool read_matrix_from_file(char matrix[16][5])
         }
     }
 
-    // tokenizza la riga per ottenere 16 celle
+    // tokenizza la riga per ottenere board_dim * board_dim celle
     char *token = strtok(line, " \t\r\n");
-    for (int i = 0; i < 16; i++)
+    for (int i = 0; i < g_server.board_dim * g_server.board_dim; i++)
     {
         if (token == NULL)
         {
@@ -138,1026 +121,2196 @@ bool read_matrix_from_file(char matrix[16][5])
     return true;
 }
 
-// ======================= gestione SIGINT =======================
 /*
-    signal_handler:
-        handlere per SIGINT che imposta il flag di stop del server e chiude socket in ascolto per uscire dal loop di accept
+    publish_pause:
+        pubblica lo snapshot della pausa che inizia ora: stessa matrice di 'prev' (se presente),
+        nessuna parola valida, fine prevista tra break_time secondi
+
     si assume che:
-        - il segnale passato sia gestito correttamente.
+        - venga chiamata dall'orchestrator (o dall'inizializzazione prima del suo avvio)
+        - prev sia lo snapshot corrente o NULL
 */
-void sigint_handler(int signo)
+void publish_pause(const game_snapshot *prev)
 {
-    (void)signo;
-    log_event("[SYSTEM] Ricevuto SIGINT, avvio shutdown");
-    server_shutdown();
+    game_snapshot *snap = calloc(1, sizeof(game_snapshot));
+    if (!snap)
+    {
+        log_event("[ORCHESTRATOR] Memoria esaurita, stato della pausa non pubblicato");
+        return;
+    }
+    if (prev)
+    {
+        snap->round = prev->round;
+        snap->dim = prev->dim;
+        memcpy(snap->matrix, prev->matrix, sizeof(snap->matrix));
+        memcpy(snap->matrix_str, prev->matrix_str, sizeof(snap->matrix_str));
+        snap->board = prev->board;
+    }
+    else
+    {
+        snap->dim = g_server.board_dim;
+    }
+    snap->running = false;
+    snap->start_time = time(NULL);
+    snap->end_time = snap->start_time + g_server.break_time;
+    snapshot_publish(snap);
 }
 
+// ======================= invio messaggi ai client =======================
 /*
-    sigalarm_handler:
-        handler vuoto per SIGALRM, viene usato solo per interrompere temporaneamente la read bloccante nel client_thread
+    client_flush_locked:
+        modalita' epoll: scrive senza bloccare quanto possibile del buffer di uscita del client.
+        se il socket non accetta tutto, registra EPOLLOUT: il reactor riprendera' l'invio
+        restituisce -1 in caso di errore sul socket
+
     si assume che:
-        - il segnale passato sia gestito correttamente
-        - il segnale venga usato solo per interrompere la read bloccante
+        - il chiamante possieda c->out_mutex e il socket sia aperto
 */
-void sigalarm_handler(int signo)
+int client_flush_locked(client_info *c)
 {
-    // per evitare waring
-    (void)signo;
-    // rimane vuoto, unico scopo e' interrompere la read bloccante
+    size_t written = 0;
+    while (written < c->out_len)
+    {
+        ssize_t n = write(c->sockfd, c->out_buf + written, c->out_len - written);
+        if (n > 0)
+        {
+            written += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        return -1;
+    }
+    // rimuove i dati scritti dal buffer
+    memmove(c->out_buf, c->out_buf + written, c->out_len - written);
+    c->out_len -= written;
+
+    bool want_write = c->out_len > 0;
+    if (want_write != c->want_write)
+    {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = want_write ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        ev.data.u32 = (uint32_t)c->idx;
+        epoll_ctl(g_server.epoll_fd, EPOLL_CTL_MOD, c->sockfd, &ev);
+        c->want_write = want_write;
+    }
+    return 0;
 }
 
-// ======================= broadcast di shutdown =======================
 /*
-    broadcast_server_shutdown:
-        invia a tutti i client connessi un messaggio di shutdown bloccando forzamente further comunicazioni
+    client_reserve_locked:
+        modalita' epoll: garantisce spazio per altri 'size' byte nel buffer di uscita.
+        un client che lascia accumulare piu' di CLIENT_OUT_MAX byte viene marcato per la chiusura
 
     si assume che:
-        - la struttura g_server.clients sia correttamente inizializzata
-        - i client siano connessi e abbiano un socket valido
+        - il chiamante possieda c->out_mutex
 */
-void broadcast_server_shutdown()
+int client_reserve_locked(client_info *c, size_t size)
 {
-    pthread_mutex_lock(&g_server.clients_mutex);
-
-    for (int i = 0; i < MAX_CLIENTS; i++)
+    size_t needed = c->out_len + size;
+    if (needed > CLIENT_OUT_MAX)
     {
-        if (g_server.clients[i].connected)
-
-        {
-            // blocca le successive comunicazioni, != chiusura(eliminazione) socket
-            shutdown(g_server.clients[i].sockfd, SHUT_RDWR);
-            send_message(g_server.clients[i].sockfd, MSG_SERVER_SHUTDOWN, "Server shutdown", strlen("Server shutdown") + 1);
-            close(g_server.clients[i].sockfd);
-
-            // segnalazione disconnessione
-            g_server.clients[i].connected = false;
-            g_server.clients[i].username[0] = '\0';
-            log_event("[ACCEPT] Chiusura connessione per client in slot %d", i);
-        }
+        c->out_overflow = true;
+        return -1;
     }
-    pthread_mutex_unlock(&g_server.clients_mutex);
+    if (needed > c->out_capacity)
+    {
+        size_t new_capacity = c->out_capacity ? c->out_capacity : BUFFER_SIZE;
+        while (new_capacity < needed)
+            new_capacity *= 2;
+        char *tmp = realloc(c->out_buf, new_capacity);
+        if (!tmp)
+            return -1;
+        c->out_buf = tmp;
+        c->out_capacity = new_capacity;
+    }
+    return 0;
 }
 
-// ======================= push_score =======================
 /*
-    push_score:
-        Aggiunge il punteggio di un utente alla coda dei punteggi se l'username non è vuoto.
-        viene chiamata quando la partita termina o quando il client invia manualmente il proprio score (se non l'ha gia' fatto)
+    client_queue_locked:
+        modalita' epoll: accoda un messaggio [type][lunghezza][data] nel buffer di uscita e prova a inviarlo.
 
     si assume che:
-        - l'username sia una stringa valida
-        - il punteggio sia un intero valido
-        - la coda dei punteggi sia correttamente inizializzata
+        - il chiamante possieda c->out_mutex e il socket sia aperto
 */
-void push_score(const char *username, int score)
+int client_queue_locked(client_info *c, char type, const char *data, unsigned int length)
 {
-    // controlla nome utente
-    if (username[0] == '\0')
-        return;
-    pthread_mutex_lock(&score_queue_mutex);
-    if (g_score_queue.count < MAX_SCORE_MSG)
-    {
-        strncpy(g_score_queue.messages[g_score_queue.count].username, username, USERNAME_LEN - 1);
-        g_score_queue.messages[g_score_queue.count].username[USERNAME_LEN - 1] = '\0';
-        g_score_queue.messages[g_score_queue.count].score = score;
-        g_score_queue.count++;
-        log_event("[SYSTEM] Punteggio push: %s -> %d (count=%d)", username, score, g_score_queue.count);
-    }
-    // segnala a eventuali tread in attesa che un nuovo punteggio e' disonibile
-    pthread_cond_signal(&score_queue_cond);
-    pthread_mutex_unlock(&score_queue_mutex);
+    if (client_reserve_locked(c, FRAME_HEADER_SIZE + length) < 0)
+        return -1;
+    unsigned int netlen = htonl(length);
+    c->out_buf[c->out_len] = type;
+    memcpy(c->out_buf + c->out_len + 1, &netlen, 4);
+    if (length > 0)
+        memcpy(c->out_buf + c->out_len + FRAME_HEADER_SIZE, data, length);
+    c->out_len += FRAME_HEADER_SIZE + length;
+    return client_flush_locked(c);
 }
 
-// Funzione di cleanup per il thread orchestrator
 /*
+    client_queue_frame_locked:
+        modalita' epoll: accoda un frame gia' serializzato (solo una copia, nessuna formattazione)
+        e prova a inviarlo.
+
     si assume che:
-        - arg sia NULL
+        - il chiamante possieda c->out_mutex e il socket sia aperto
 */
-void orchestrator_cleanup(void *arg)
+int client_queue_frame_locked(client_info *c, const frame *f)
 {
-    (void)arg;
-    log_event("[ORCHESTRATOR] Terminato");
+    if (client_reserve_locked(c, f->size) < 0)
+        return -1;
+    memcpy(c->out_buf + c->out_len, f->data, f->size);
+    c->out_len += f->size;
+    return client_flush_locked(c);
 }
 
-//======================= THREAD ORCHESTRATOR =======================
-// thread per gestione client, orchestratore
 /*
-    orchestrator_thread:
-        gestisce il ciclo di vita della partia
-        1) Imposta lo stato di gioco come attivo e genera (o legge) la matrice di gioco.
-        2) Azzera punteggi e parole usate per tutti i client connessi.
-        3) Attende la durata configurata per la partita.
-        4) Alla fine, forza l'invio dei punteggi e avvia la fase di pausa.
-        5) Ripete il ciclo finché il server non viene fermato.
+    client_send_result_locked:
+        modalita' thread: esito di un invio bloccante. un invio fallito (SO_SNDTIMEO scaduto
+        perche' il client non legge, o errore del socket) puo' aver lasciato un messaggio a meta':
+        il client viene marcato (out_overflow) e il socket chiuso con shutdown, cosi' la read del
+        suo thread fallisce e lo disconnette. gli invii successivi falliscono senza scrivere
 
     si assume che:
-        - la struttura g_server e i variabili globali sia correttamente inizializzata
+        - il chiamante possieda c->out_mutex e il socket sia aperto
 */
-void *orchestrator_thread(void *arg)
+static int client_send_result_locked(client_info *c, int ret)
 {
-    (void)arg;
-    // registrazione cleanup handler
-    pthread_cleanup_push(orchestrator_cleanup, NULL);
+    if (ret < 0 && !c->out_overflow)
+    {
+        c->out_overflow = true;
+        log_event("[CLIENT] Invio al client %d fallito o bloccato per %d secondi: disconnessione", c->idx, CLIENT_SEND_TIMEOUT);
+        shutdown(c->sockfd, SHUT_RDWR);
+    }
+    return ret;
+}
 
-    // Abilita la cancellazione (cancellation point)
-    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
-    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
+/*
+    client_send:
+        invia un messaggio al client 'idx', serializzando gli invii concorrenti con out_mutex
+        - modalita' thread: scrittura bloccante con send_message, al piu' CLIENT_SEND_TIMEOUT secondi
+        - modalita' epoll: il messaggio viene accodato e scritto senza bloccare, il resto lo invia il reactor
+        restituisce 0 in caso di successo, -1 se il socket e' chiuso o in caso di errore
 
-    while (!g_server.stop)
+    si assume che:
+        - idx sia un indice valido in g_server.clients
+*/
+int client_send(int idx, char type, const char *data, unsigned int length)
+{
+    client_info *c = g_server.clients[idx];
+    int ret = -1;
+    pthread_mutex_lock(&c->out_mutex);
+    if (c->sockfd >= 0)
     {
-        // terminazione thread in modo sicuro e rapida
-        // controlla se e' stata richiesta la cancellazione (pthread_cancel), se si, termina in modo sicuro
-        pthread_testcancel();
-
-        // inizio partita
-        pthread_mutex_lock(&g_server.clients_mutex);
-        g_server.game_running = true;
-        g_server.game_start_time = time(NULL);
-        log_event("[ORCHESTRATOR] Inizio partita");
-        pthread_mutex_unlock(&g_server.clients_mutex);
+        if (g_server.use_epoll)
+            ret = client_queue_locked(c, type, data, length);
+        else if (!c->out_overflow)
+            ret = client_send_result_locked(c, send_message(c->sockfd, type, data, length));
+    }
+    pthread_mutex_unlock(&c->out_mutex);
+    return ret;
+}
 
-        // se specificato, leggi matrice da file, altrimenti generazione casuale
-        if (g_server.matrix_fp)
-        {
-            rewind(g_server.matrix_fp); // assicura la lettura all'inizio
-            if (!read_matrix_from_file(g_server.matrix))
-            {
-                log_event("[ORCHESTRATOR] Impossibile leggere matrice dal file, generazione casuale di matrice");
-                unsigned int effective_seed = (g_server.seed >= 0) ? (unsigned int)g_server.seed : (unsigned int)time(NULL);
-                generate_matrix(g_server.matrix, effective_seed);
-            }
-        }
-        else
-        {
-            unsigned int effective_seed = (g_server.seed >= 0) ? (unsigned int)g_server.seed : (unsigned int)time(NULL);
-            generate_matrix(g_server.matrix, effective_seed);
-        }
+/*
+    client_send_conn:
+        come client_send, ma invia solo se lo slot appartiene ancora alla connessione 'conn_id'
+        (usata da chi invia fuori da clients_mutex: worker, orchestrator, scorer)
+*/
+int client_send_conn(int idx, unsigned int conn_id, char type, const char *data, unsigned int length)
+{
+    client_info *c = g_server.clients[idx];
+    int ret = -1;
+    pthread_mutex_lock(&c->out_mutex);
+    if (c->sockfd >= 0 && c->conn_id == conn_id)
+    {
+        if (g_server.use_epoll)
+            ret = client_queue_locked(c, type, data, length);
+        else if (!c->out_overflow)
+            ret = client_send_result_locked(c, send_message(c->sockfd, type, data, length));
+    }
+    pthread_mutex_unlock(&c->out_mutex);
+    return ret;
+}
 
-        // reset punteggi e parole usate
-        pthread_mutex_lock(&g_server.clients_mutex);
-        for (int i = 0; i < MAX_CLIENTS; ++i)
-        {
-            if (g_server.clients[i].connected)
-            {
-                g_server.clients[i].score = 0;
-                g_server.clients[i].used_words_count = 0;
-                g_server.clients[i].score_sent = false;
-                g_server.clients[i].in_game = true;
-            }
-        }
-        pthread_mutex_unlock(&g_server.clients_mutex);
+/*
+    client_send_batch:
+        come client_send, per piu' messaggi destinati allo stesso client:
+        - modalita' thread: una sola writev per tutto il batch
+        - modalita' epoll: i messaggi vengono copiati nel buffer di uscita e scritti con un solo flush
+        il batch viene svuotato
 
-        // Invia notifica di inizio partita a tutti i client
-        pthread_mutex_lock(&g_server.clients_mutex);
-        char matrix_buf[BUFFER_SIZE] = "";
-        for (int i = 0; i < 16; i++)
+    si assume che:
+        - idx sia un indice valido in g_server.clients
+*/
+int client_send_batch(int idx, msg_batch *batch)
+{
+    client_info *c = g_server.clients[idx];
+    int ret = -1;
+    pthread_mutex_lock(&c->out_mutex);
+    if (c->sockfd >= 0)
+    {
+        if (!g_server.use_epoll)
         {
-            strcat(matrix_buf, g_server.matrix[i]);
-            if (i < 15)
-            {
-                strcat(matrix_buf, " ");
-            }
+            if (!c->out_overflow)
+                ret = client_send_result_locked(c, msg_batch_send(c->sockfd, batch));
         }
-        for (int i = 0; i < MAX_CLIENTS; i++)
+        else if (client_reserve_locked(c, batch->size) == 0)
         {
-            if (g_server.clients[i].connected && g_server.clients[i].username[0] != '\0')
+            for (int i = 0; i < batch->iov_count; i++)
             {
-                send_message(g_server.clients[i].sockfd, MSG_OK, "Nuova partita iniziata", strlen("Nuova partita iniziata") + 1);
-                send_message(g_server.clients[i].sockfd, MSG_MATRICE, matrix_buf, strlen(matrix_buf) + 1);
+                memcpy(c->out_buf + c->out_len, batch->iov[i].iov_base, batch->iov[i].iov_len);
+                c->out_len += batch->iov[i].iov_len;
             }
+            ret = client_flush_locked(c);
         }
-        pthread_mutex_unlock(&g_server.clients_mutex);
+    }
+    pthread_mutex_unlock(&c->out_mutex);
+    msg_batch_init(batch);
+    return ret;
+}
 
-        log_event("[ORCHESTRATOR] Nuova partiata iniziata, durata %d secondi", g_server.game_duration);
-        safe_printf("[ORCHESTRATOR] Nuova partita iniziata, durata %d secondi\n", g_server.game_duration);
+/*
+    client_write_frame_locked:
+        invia un frame gia' serializzato: in modalita' thread l'intero messaggio
+        viene scritto con una sola write, in modalita' epoll viene accodato
 
-        // attesa durante la partita
-        time_t game_start = g_server.game_start_time;
-        while (!g_server.stop && difftime(time(NULL), game_start) < g_server.game_duration)
-        {
-            pthread_testcancel();
-            struct timespec req = {0, 10000 * 1000}; // 10 ms
-            nanosleep(&req, NULL);
-        }
+    si assume che:
+        - il chiamante possieda c->out_mutex e il socket sia aperto
+*/
+int client_write_frame_locked(client_info *c, const frame *f)
+{
+    if (g_server.use_epoll)
+        return client_queue_frame_locked(c, f);
+    if (c->out_overflow)
+        return -1;
+    return client_send_result_locked(c, robust_write(c->sockfd, f->data, f->size) == (ssize_t)f->size ? 0 : -1);
+}
 
-        // fine partita
-        pthread_mutex_lock(&g_server.clients_mutex);
-        g_server.game_running = false;
-        int count_connected = 0;
-        for (int i = 0; i < MAX_CLIENTS; i++)
-        {
-            if (g_server.clients[i].connected &&
-                g_server.clients[i].username[0] != '\0')
-            {
-                count_connected++;
-            }
-        }
-        log_event("[ORCHESTRATOR] Fine partita, %d client connessi", count_connected);
-        pthread_mutex_unlock(&g_server.clients_mutex);
+/*
+    client_send_frame_conn:
+        come client_send_conn, per un frame gia' serializzato condiviso tra piu' destinatari
+        (broadcast di orchestrator e scorer)
 
-        // Quando la partita termina, invia il segnale SIGALRM a tutti i thread client per "svegliarli":
-        pthread_mutex_lock(&g_server.clients_mutex);
-        for (int i = 0; i < MAX_CLIENTS; i++)
-        {
-            if (g_server.clients[i].connected)
-            {
-                pthread_kill(g_server.clients[i].thread_id, SIGALRM);
-            }
-        }
-        pthread_mutex_unlock(&g_server.clients_mutex);
+    si assume che:
+        - f non sia NULL e il chiamante ne possieda un riferimento per tutta la chiamata
+*/
+int client_send_frame_conn(int idx, unsigned int conn_id, const frame *f)
+{
+    client_info *c = g_server.clients[idx];
+    int ret = -1;
+    pthread_mutex_lock(&c->out_mutex);
+    if (c->sockfd >= 0 && c->conn_id == conn_id)
+        ret = client_write_frame_locked(c, f);
+    pthread_mutex_unlock(&c->out_mutex);
+    return ret;
+}
 
-        // Attende brevemente per consentire ai client di inviare il punteggio
-        sleep(1);
+/*
+    client_reject_too_long:
+        risponde con MSG_ERR a un frame oltre CLIENT_IN_MAX_PAYLOAD, prima della chiusura
+        della connessione. la close con byte non letti nel buffer di ricezione invierebbe un RST,
+        che al client fa perdere la risposta: si chiude la scrittura (FIN dopo MSG_ERR) e si
+        scartano, senza attenderne altri, i byte del frame gia' arrivati
 
-        // Forza l'invio del punteggio per i client che non l'hanno ancora inviato
-        pthread_mutex_lock(&g_server.clients_mutex);
-        for (int i = 0; i < MAX_CLIENTS; i++)
-        {
-            if (g_server.clients[i].connected && !g_server.clients[i].score_sent && g_server.clients[i].in_game)
-            {
-                push_score(g_server.clients[i].username, g_server.clients[i].score);
-                g_server.clients[i].score_sent = true;
-                log_event("[ORCHESTRATOR] Punteggio forzato inviato per %s", g_server.clients[i].username);
-            }
-        }
-        pthread_mutex_unlock(&g_server.clients_mutex);
+    si assume che:
+        - venga chiamata dal thread che legge il socket del client (thread del client o reactor)
+*/
+void client_reject_too_long(int idx)
+{
+    client_info *c = g_server.clients[idx];
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Messaggio troppo lungo (massimo %d byte)", CLIENT_IN_MAX_PAYLOAD);
+    client_send(idx, MSG_ERR, msg, strlen(msg) + 1);
 
-        // Imposta il numero di punteggi attesi nella coda per questa partita
-        pthread_mutex_lock(&score_queue_mutex);
-        g_score_queue.expected = count_connected;
-        pthread_mutex_unlock(&score_queue_mutex);
+    pthread_mutex_lock(&c->out_mutex);
+    if (c->sockfd >= 0)
+    {
+        shutdown(c->sockfd, SHUT_WR);
+        char discard[4096];
+        for (int i = 0; i < 16 && recv(c->sockfd, discard, sizeof(discard), MSG_DONTWAIT) > 0; i++)
+            ;
+    }
+    pthread_mutex_unlock(&c->out_mutex);
+}
 
-        if (count_connected == 0)
-        {
-            log_event("[ORCHESTRATOR] Nessun client connesso, salto invio classifica.");
-            pthread_mutex_lock(&ranking_mutex);
-            ranking_sent = true;
-            pthread_cond_signal(&ranking_cond);
-            pthread_mutex_unlock(&ranking_mutex);
-        }
-        else
-        {
-            // Aspetta che la classifica sia stata inviata
-            pthread_mutex_lock(&ranking_mutex);
-            while (!ranking_sent)
-            {
-                if (g_server.stop)
-                    break;
-
-                struct timespec ts;
-                clock_gettime(CLOCK_REALTIME, &ts);
-                ts.tv_sec += 1; // timeout di 1 secondo
-                int ret = pthread_cond_timedwait(&ranking_cond, &ranking_mutex, &ts);
-                (void)ret;
-                pthread_testcancel();
-                if (g_server.stop)
-                    break;
-            }
-            ranking_sent = false;
-            pthread_mutex_unlock(&ranking_mutex);
-        }
-        // imposta il tempo di inizio della pausa
-        g_server.break_start_time = time(NULL);
+// ======================= gestione SIGINT =======================
+/*
+    signal_handler:
+        handlere per SIGINT che imposta il flag di stop del server e sblocca il loop di accept.
+        lo shutdown lo completa il main all'uscita dal loop (accept o reactor): nel gestore
+        si usano solo operazioni async-signal-safe, il segnale puo' arrivare a qualsiasi thread
+    si assume che:
+        - il segnale passato sia gestito correttamente.
+*/
+void sigint_handler(int signo)
+{
+    (void)signo;
+    g_server.stop = true;
+    // il reactor esce dal loop entro un giro di epoll_wait; in modalita' thread per client
+    // shutdown() risveglia l'accept bloccata anche se il segnale e' arrivato a un altro thread
+    if (!g_server.use_epoll)
+        shutdown(g_server.server_sockfd, SHUT_RDWR);
+}
 
-        // pausa tra partite
-        safe_printf("[ORCHESTRATOR] Partita terminata, pausa tra partite di %d secondi\n", g_server.break_time);
-        log_event("[ORCHESTRATOR] Inizio pausa di %d secondi", g_server.break_time);
+// ======================= verbosita' della console =======================
+static const char *console_level_name(int level)
+{
+    return level == CONSOLE_OFF ? "off" : (level == CONSOLE_INFO ? "info" : "debug");
+}
 
-        while (!g_server.stop && difftime(time(NULL), g_server.break_start_time) < g_server.break_time)
-        {
-            pthread_testcancel();
-            struct timespec req = {0, 10000 * 1000}; // 10 ms
-            nanosleep(&req, NULL);
-        }
+/*
+    verbosity_handler:
+        handler per SIGUSR1 (un livello di verbosita' in piu') e SIGUSR2 (un livello in meno).
+        il log non e' async-signal-safe: il gestore cambia solo console_level e scrive
+        verbosity_event_fd, il nuovo livello viene registrato dall'orchestrator
+*/
+void verbosity_handler(int signo)
+{
+    int saved_errno = errno;
+    int level = __atomic_load_n(&console_level, __ATOMIC_RELAXED);
+    if (signo == SIGUSR1 && level < CONSOLE_DEBUG)
+        level++;
+    else if (signo == SIGUSR2 && level > CONSOLE_OFF)
+        level--;
+    __atomic_store_n(&console_level, level, __ATOMIC_RELAXED);
+    uint64_t one = 1;
+    if (write(g_server.verbosity_event_fd, &one, sizeof(one)) < 0)
+    {
+        // contatore saturo: l'orchestrator ha gia' un cambio da registrare
     }
-    pthread_cleanup_pop(1);
-    return NULL;
+    errno = saved_errno;
 }
 
-// ======================= thread scorer =======================
+// ======================= tabella dei client =======================
 /*
-    scorer_thread:
-        gestisce la raccolta e l'elaborazione dei punteggi finali della partita
-        - attende che tutti i client abbiano inviato i propri punteggi tramcte la coda condivisa
-        - utilizza una condition variable per sincronizzarsi con i thread client e attendere il completamento
-        - quando tutti i punteggi attesi sono stati raccolti:
-            + ordina i punteggi in ordine decrescente per generare la classifica finale
-            + costruisce un messaggio MSG_PUNTI_FINALI contenente la classifica in formato CSV
-            + invia il messaggio MSG_PUNTI_FINALI a tutti i client connessi
-        - registra l'evento nel file di log
-        - si ripete per ogni partita, azzerando la coda dei punteggi per la partita successiva
-        - termina solo quando il server viene arrestato
+    client_clear_words_locked:
+        svuota in O(1) l'insieme delle parole proposte dal client (nuova partita o nuova connessione)
 
     si assume che:
-        - la coda dei punteggi sia correttamente inizializzata
-        - la condition variable sia correttamente inizializzata
-        - la struttura g_server sia correttamente inizializzata
+        - il chiamante possieda c->state_mutex
 */
-void *scorer_thread(void *arg)
+void client_clear_words_locked(client_info *c)
 {
-    (void)arg;
-    // Abilita la cancellazione
-    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
-    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
-
-    while (!g_server.stop)
+    // allo scorrere del contatore un vecchio valore potrebbe tornare valido: si azzera l'array
+    if (++c->used_stamp == 0)
     {
-        pthread_testcancel();
-        pthread_mutex_lock(&score_queue_mutex);
-
-        // Se expected è 0, non ci sono client connessi: rilascio e attendo un po'
-        if (g_score_queue.expected == 0)
-        {
-            pthread_mutex_unlock(&score_queue_mutex);
-            sleep(1);
-            continue;
-        }
-        struct timespec ts;
-        clock_gettime(CLOCK_REALTIME, &ts);
-        ts.tv_sec += 1; // attesa massima di 1 secondo
+        if (c->used_words)
+            memset(c->used_words, 0, c->used_capacity * sizeof(unsigned int));
+        c->used_stamp = 1;
+    }
+}
 
-        // attesa finche count < expected
-        while (g_score_queue.count < g_score_queue.expected && !g_server.stop)
-        {
-            int ret = pthread_cond_timedwait(&score_queue_cond, &score_queue_mutex, &ts);
-            (void)ret;
-            pthread_testcancel();
-            if (g_server.stop)
-                break;
-        }
+/*
+    client_join_leaderboard_locked:
+        iscrive il client autenticato c alla classifica della partita in corso. se lo stesso
+        utente si era disconnesso durante la partita ne riprende l'elemento con punteggio e
+        parole gia' proposte, altrimenti entra con il punteggio attuale
 
-        // se il server e' in shutdown esce
-        if (g_server.stop)
-        {
-            pthread_mutex_unlock(&score_queue_mutex);
-            break;
-        }
+    si assume che:
+        - il chiamante possieda c->state_mutex
+        - c->rank_entry sia NULL e c->username sia impostato
+*/
+void client_join_leaderboard_locked(client_info *c)
+{
+    lb_player_state state;
+    c->rank_entry = leaderboard_rejoin(c->username, &state);
+    if (!c->rank_entry)
+    {
+        c->rank_entry = leaderboard_join(c->username, c->score);
+        return;
+    }
+    free(c->used_words);
+    c->used_words = state.used_words;
+    c->used_capacity = state.used_capacity;
+    c->used_stamp = state.used_stamp;
+    c->score = state.score;
+    log_event("[CLIENT] %s rientra in classifica con %d punti", c->username, c->score);
+}
 
-        // copia locale di punteggi raccolti
-        int n = g_score_queue.count;
-        ScoreMsg local_scores[MAX_SCORE_MSG];
-        for (int i = 0; i < n; i++)
-        {
-            local_scores[i] = g_score_queue.messages[i];
-        }
+/*
+    client_slot_alloc:
+        restituisce un record libero della tabella dei client: riusa uno slot liberato
+        oppure alloca un nuovo record, fino a max_clients. i record non vengono mai liberati
+        prima dello shutdown, quindi indici e puntatori restano validi per worker e reactor
+        restituisce NULL se la tabella e' piena o la memoria e' esaurita
 
-        // reset della coda per prossima partita
-        g_score_queue.count = 0;
-        pthread_mutex_unlock(&score_queue_mutex);
+    si assume che:
+        - il chiamante possieda clients_mutex
+*/
+client_info *client_slot_alloc()
+{
+    if (g_server.free_slot >= 0)
+    {
+        client_info *c = g_server.clients[g_server.free_slot];
+        g_server.free_slot = c->next_free;
+        return c;
+    }
+    if (g_server.client_slots >= g_server.max_clients)
+        return NULL;
 
-        // ordinamento (bubble sort)
-        for (int i = 0; i < n - 1; i++)
-        {
-            for (int j = i + 1; j < n; j++)
+    client_info *c = calloc(1, sizeof(client_info));
+    if (!c)
+        return NULL;
+    if (msg_reader_init(&c->reader, -1, CLIENT_IN_MAX_PAYLOAD) < 0)
+    {
+        free(c);
+        return NULL;
+    }
+    pthread_mutex_init(&c->out_mutex, NULL);
+    pthread_mutex_init(&c->state_mutex, NULL);
+    c->sockfd = -1;
+    c->idx = g_server.client_slots;
+    g_server.clients[c->idx] = c;
+    g_server.client_slots++;
+    return c;
+}
+
+/*
+    client_link / client_unlink:
+        inserisce/rimuove il client dalla lista dei client connessi (scorsa da broadcast e controlli)
+
+    si assume che:
+        - il chiamante possieda clients_mutex
+*/
+void client_link(client_info *c)
+{
+    c->connected = true;
+    c->prev_active = NULL;
+    c->next_active = g_server.active_head;
+    if (g_server.active_head)
+        g_server.active_head->prev_active = c;
+    g_server.active_head = c;
+    g_server.active_count++;
+}
+
+void client_unlink(client_info *c)
+{
+    if (c->prev_active)
+        c->prev_active->next_active = c->next_active;
+    else
+        g_server.active_head = c->next_active;
+    if (c->next_active)
+        c->next_active->prev_active = c->prev_active;
+    c->prev_active = c->next_active = NULL;
+    c->connected = false;
+    g_server.active_count--;
+}
+
+/*
+    client_slot_release:
+        scollega il client e rende lo slot riutilizzabile per una nuova connessione
+
+    si assume che:
+        - il chiamante possieda clients_mutex
+        - il client sia nella lista dei connessi
+*/
+void client_slot_release(client_info *c)
+{
+    client_unlink(c);
+    c->next_free = g_server.free_slot;
+    g_server.free_slot = c->idx;
+}
+
+/*
+    client_snapshot:
+        copia sotto clients_mutex i riferimenti (slot, connessione) dei client connessi,
+        cosi' i broadcast scrivono sui socket senza tenere lock globali.
+        restituisce il numero di riferimenti, *refs va liberato dal chiamante (NULL se 0 o memoria esaurita)
+*/
+int client_snapshot(client_ref **refs)
+{
+    pthread_mutex_lock(&g_server.clients_mutex);
+    int n = 0;
+    *refs = g_server.active_count > 0 ? malloc(g_server.active_count * sizeof(client_ref)) : NULL;
+    if (*refs)
+    {
+        for (client_info *c = g_server.active_head; c; c = c->next_active)
+        {
+            (*refs)[n].idx = c->idx;
+            (*refs)[n].conn_id = c->conn_id;
+            (*refs)[n].logged_in = c->username[0] != '\0';
+            n++;
+        }
+    }
+    pthread_mutex_unlock(&g_server.clients_mutex);
+    return n;
+}
+
+// ======================= sessioni (username -> client) =======================
+
+// FNV-1a sul nome utente
+static uint32_t session_hash(const char *username)
+{
+    uint32_t h = 2166136261u;
+    for (; *username; username++)
+    {
+        h ^= (unsigned char)*username;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static pthread_mutex_t *session_lock(uint32_t bucket)
+{
+    return &g_server.session_locks[bucket % SESSION_STRIPES];
+}
+
+/*
+    session_claim:
+        associa 'username' al client c (impostandone c->username) se nessun altro client
+        e' autenticato con quel nome. controllo e inserimento avvengono sotto lo stesso lock
+        di stripe: due login contemporanei con lo stesso nome non possono riuscire entrambi.
+        restituisce false se il nome e' gia' associato ad un client
+
+    si assume che:
+        - c non sia gia' associato ad un nome
+        - il chiamante possieda clients_mutex (gli altri thread leggono username sotto clients_mutex)
+*/
+bool session_claim(client_info *c, const char *username)
+{
+    uint32_t bucket = session_hash(username) & (g_server.session_buckets - 1);
+    pthread_mutex_t *lock = session_lock(bucket);
+    pthread_mutex_lock(lock);
+    for (client_info *s = g_server.sessions[bucket]; s; s = s->next_session)
+    {
+        if (strcmp(s->username, username) == 0)
+        {
+            pthread_mutex_unlock(lock);
+            return false;
+        }
+    }
+    strncpy(c->username, username, USERNAME_LEN - 1);
+    c->username[USERNAME_LEN - 1] = '\0';
+    c->next_session = g_server.sessions[bucket];
+    g_server.sessions[bucket] = c;
+    pthread_mutex_unlock(lock);
+    return true;
+}
+
+/*
+    session_release:
+        rimuove l'associazione del client c con il suo username, se presente
+
+    si assume che:
+        - c->username non cambi durante la chiamata (il chiamante possiede clients_mutex)
+*/
+void session_release(client_info *c)
+{
+    if (c->username[0] == '\0')
+        return;
+    uint32_t bucket = session_hash(c->username) & (g_server.session_buckets - 1);
+    pthread_mutex_t *lock = session_lock(bucket);
+    pthread_mutex_lock(lock);
+    for (client_info **link = &g_server.sessions[bucket]; *link; link = &(*link)->next_session)
+    {
+        if (*link == c)
+        {
+            *link = c->next_session;
+            break;
+        }
+    }
+    c->next_session = NULL;
+    pthread_mutex_unlock(lock);
+}
+
+/*
+    session_contains:
+        true se un client e' autenticato con 'username' (costo indipendente dal numero di connessi)
+*/
+bool session_contains(const char *username)
+{
+    uint32_t bucket = session_hash(username) & (g_server.session_buckets - 1);
+    pthread_mutex_t *lock = session_lock(bucket);
+    bool found = false;
+    pthread_mutex_lock(lock);
+    for (client_info *s = g_server.sessions[bucket]; s && !found; s = s->next_session)
+        found = strcmp(s->username, username) == 0;
+    pthread_mutex_unlock(lock);
+    return found;
+}
+
+// ======================= broadcast di shutdown =======================
+/*
+    broadcast_server_shutdown:
+        invia a tutti i client connessi un messaggio di shutdown bloccando forzamente further comunicazioni
+
+    si assume che:
+        - la struttura g_server.clients sia correttamente inizializzata
+        - i client siano connessi e abbiano un socket valido
+*/
+void broadcast_server_shutdown()
+{
+    client_ref *refs;
+    int n = client_snapshot(&refs);
+    for (int i = 0; i < n; i++)
+    {
+        client_info *c = g_server.clients[refs[i].idx];
+        client_send_conn(c->idx, refs[i].conn_id, MSG_SERVER_SHUTDOWN, "Server shutdown", strlen("Server shutdown") + 1);
+
+        pthread_mutex_lock(&c->out_mutex);
+        if (c->sockfd >= 0)
+        {
+            // blocca le successive comunicazioni, != chiusura(eliminazione) socket
+            shutdown(c->sockfd, SHUT_RDWR);
+            // in modalita' thread per client la read del thread fallisce e il socket lo chiude
+            // client_disconnect: chiuderlo qui renderebbe riutilizzabile un descrittore ancora letto
+            if (g_server.use_epoll)
             {
-                if (local_scores[i].score < local_scores[j].score)
-                {
-                    ScoreMsg temp = local_scores[i];
-                    local_scores[i] = local_scores[j];
-                    local_scores[j] = temp;
-                }
+                close(c->sockfd);
+                c->sockfd = -1;
             }
         }
+        pthread_mutex_unlock(&c->out_mutex);
 
-        // costruzione della stringa per classifica
-        char classifica[BUFFER_SIZE] = "";
-        int offset = 0;
+        // segnalazione disconnessione
+        pthread_mutex_lock(&g_server.clients_mutex);
+        session_release(c);
+        c->username[0] = '\0';
+        if (c->connected)
+            client_unlink(c);
+        pthread_mutex_unlock(&g_server.clients_mutex);
+        log_event("[ACCEPT] Chiusura connessione per client in slot %d", c->idx);
+    }
+    free(refs);
+}
 
-        if (n > 0)
+// Funzione di cleanup per il thread orchestrator
+/*
+    si assume che:
+        - arg sia NULL
+*/
+void orchestrator_cleanup(void *arg)
+{
+    (void)arg;
+    log_event("[ORCHESTRATOR] Terminato");
+}
+
+/*
+    mutex_cleanup:
+        cleanup handler che rilascia il mutex 'arg': un thread cancellato mentre e' in
+        pthread_cond_wait riprende il mutex prima di terminare e non deve lasciarlo bloccato
+*/
+void mutex_cleanup(void *arg)
+{
+    pthread_mutex_unlock((pthread_mutex_t *)arg);
+}
+
+// classifica parziale inviata per ultima nella partita in corso (solo orchestrator)
+static unsigned long live_version;
+static char live_top[LIVE_TOP_MAX];
+
+/*
+    live_ranking_tick:
+        a ogni tick durante la partita invia MSG_CLASSIFICA_LIVE ai client autenticati, ma solo
+        se i primi LIVE_TOP_K sono cambiati dall'ultimo invio: molte parole accettate nello
+        stesso intervallo producono al piu' un messaggio per client
+
+    si assume che:
+        - venga chiamata solo dall'orchestrator
+*/
+void live_ranking_tick()
+{
+    // nessuna parola accettata ne' nuovo giocatore dall'ultimo tick
+    unsigned long version = leaderboard_version();
+    if (version == live_version)
+        return;
+    live_version = version;
+
+    char top[LIVE_TOP_MAX];
+    size_t len = leaderboard_top(LIVE_TOP_K, top, sizeof(top));
+    if (len == 0 || strcmp(top, live_top) == 0)
+        return;
+    memcpy(live_top, top, len + 1);
+
+    frame *f = frame_create(MSG_CLASSIFICA_LIVE, top, len + 1);
+    if (!f)
+        return;
+    client_ref *refs;
+    int n_refs = client_snapshot(&refs);
+    for (int i = 0; i < n_refs; i++)
+    {
+        if (refs[i].logged_in)
+            client_send_frame_conn(refs[i].idx, refs[i].conn_id, f);
+    }
+    free(refs);
+    frame_unref(f);
+}
+
+/*
+    phase_wait_until:
+        attende l'istante 'deadline' (tempo assoluto) senza polling: il timerfd della fase
+        viene armato alla scadenza e l'orchestrator resta bloccato in poll finche' il timer
+        scatta o viene scritto stop_event_fd. se 'live' e' true (partita in corso) nel frattempo
+        il timer periodico della classifica parziale chiama live_ranking_tick; a ogni scrittura
+        di verbosity_event_fd (SIGUSR1/SIGUSR2) registra il livello di verbosita' corrente.
+        restituisce false se e' stato richiesto lo shutdown
+
+    si assume che:
+        - venga chiamata solo dall'orchestrator
+*/
+bool phase_wait_until(time_t deadline, bool live)
+{
+    // scadenza assoluta: se e' gia' passata il timer scatta subito
+    struct itimerspec its = {0};
+    its.it_value.tv_sec = deadline;
+    if (timerfd_settime(g_server.phase_timer_fd, TFD_TIMER_ABSTIME, &its, NULL) < 0)
+    {
+        log_event("[ORCHESTRATOR] timerfd_settime fallita: %s", strerror(errno));
+        return !g_server.stop;
+    }
+
+    struct itimerspec tick = {0};
+    if (live)
+    {
+        tick.it_interval.tv_sec = LIVE_TICK_MS / 1000;
+        tick.it_interval.tv_nsec = (LIVE_TICK_MS % 1000) * 1000000L;
+        tick.it_value = tick.it_interval;
+        if (timerfd_settime(g_server.live_timer_fd, 0, &tick, NULL) < 0)
+            log_event("[ORCHESTRATOR] timerfd_settime classifica parziale fallita: %s", strerror(errno));
+    }
+
+    struct pollfd fds[4] = {
+        {.fd = g_server.phase_timer_fd, .events = POLLIN},
+        {.fd = g_server.stop_event_fd, .events = POLLIN},
+        {.fd = g_server.verbosity_event_fd, .events = POLLIN},
+        {.fd = g_server.live_timer_fd, .events = POLLIN},
+    };
+    bool expired = false;
+    uint64_t expirations;
+    while (!g_server.stop && !expired)
+    {
+        // poll e' un punto di cancellazione
+        if (poll(fds, live ? 4 : 3, -1) < 0)
         {
-            // Il vincitore è il primo (dopo l'ordinamento decrescente)
-            offset += snprintf(classifica + offset, sizeof(classifica) - offset, "Vincitore: %s\n", local_scores[0].username);
+            if (errno == EINTR)
+                continue;
+            log_event("[ORCHESTRATOR] poll fallita: %s", strerror(errno));
+            break;
         }
+        if (fds[1].revents)
+            break;
+        if (fds[2].revents & POLLIN)
+        {
+            if (read(g_server.verbosity_event_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+                log_event("[ORCHESTRATOR] lettura eventfd verbosita' fallita: %s", strerror(errno));
+            log_event("[SYSTEM] Verbosita' della console: %s",
+                      console_level_name(__atomic_load_n(&console_level, __ATOMIC_RELAXED)));
+        }
+        if (live && (fds[3].revents & POLLIN))
+        {
+            if (read(g_server.live_timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+                log_event("[ORCHESTRATOR] lettura timerfd fallita: %s", strerror(errno));
+            live_ranking_tick();
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            if (read(g_server.phase_timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+                log_event("[ORCHESTRATOR] lettura timerfd fallita: %s", strerror(errno));
+            expired = true;
+        }
+    }
 
-        for (int i = 0; i < n; i++)
+    if (live)
+    {
+        // disarma il tick: in pausa l'orchestrator non viene risvegliato
+        struct itimerspec off = {0};
+        timerfd_settime(g_server.live_timer_fd, 0, &off, NULL);
+    }
+    return expired;
+}
+
+//======================= THREAD ORCHESTRATOR =======================
+// thread per gestione client, orchestratore
+/*
+    orchestrator_thread:
+        gestisce il ciclo di vita della partia
+        1) Imposta lo stato di gioco come attivo e genera (o legge) la matrice di gioco.
+        2) Azzera punteggi e parole usate per tutti i client connessi.
+        3) Attende la durata configurata per la partita.
+        4) Alla fine, fa inviare allo scorer la classifica (gia' ordinata) e avvia la fase di pausa.
+        5) Ripete il ciclo finché il server non viene fermato.
+
+    si assume che:
+        - la struttura g_server e i variabili globali sia correttamente inizializzata
+*/
+void *orchestrator_thread(void *arg)
+{
+    (void)arg;
+    // registrazione cleanup handler
+    pthread_cleanup_push(orchestrator_cleanup, NULL);
+
+    // Abilita la cancellazione (cancellation point)
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
+
+    uint64_t round = 0; // numero dell'ultima partita avviata
+
+    while (!g_server.stop)
+    {
+        // terminazione thread in modo sicuro e rapida
+        // controlla se e' stata richiesta la cancellazione (pthread_cancel), se si, termina in modo sicuro
+        pthread_testcancel();
+
+        // se specificato, leggi matrice da file, altrimenti generazione casuale
+        char matrix[BOARD_MAX_CELLS][5];
+        if (g_server.matrix_fp)
         {
-            if (i < n - 1)
-                offset += snprintf(classifica + offset, sizeof(classifica) - offset, "%s, %d, ", local_scores[i].username, local_scores[i].score);
-            else
-                offset += snprintf(classifica + offset, sizeof(classifica) - offset, "%s, %d", local_scores[i].username, local_scores[i].score);
+            rewind(g_server.matrix_fp); // assicura la lettura all'inizio
+            if (!read_matrix_from_file(matrix))
+            {
+                log_event("[ORCHESTRATOR] Impossibile leggere matrice dal file, generazione casuale di matrice");
+                unsigned int effective_seed = (g_server.seed >= 0) ? (unsigned int)g_server.seed : (unsigned int)time(NULL);
+                generate_matrix(matrix, g_server.board_dim, effective_seed);
+            }
+        }
+        else
+        {
+            unsigned int effective_seed = (g_server.seed >= 0) ? (unsigned int)g_server.seed : (unsigned int)time(NULL);
+            generate_matrix(matrix, g_server.board_dim, effective_seed);
+        }
+
+        // costruzione dello snapshot della nuova partita: matrice, stringa per il protocollo
+        // e risoluzione completa, tutto prima di aprire la partita
+        game_snapshot *snap = calloc(1, sizeof(game_snapshot));
+        if (!snap)
+        {
+            log_event("[ORCHESTRATOR] Memoria esaurita, partita non avviata");
+            sleep(1);
+            continue;
+        }
+        snap->round = ++round;
+        snap->running = true;
+        snap->dim = g_server.board_dim;
+        memcpy(snap->matrix, matrix, sizeof(matrix));
+        snapshot_render_matrix(snap);
+        encode_board(matrix, g_server.board_dim, &snap->board);
+        snap->solved = solve_board(&snap->board, g_server.dictionary);
+        if (!snap->solved)
+        {
+            // senza le parole valide nessuna parola verrebbe accettata: la partita non parte
+            log_event("[ORCHESTRATOR] Memoria esaurita durante la risoluzione della matrice, partita non avviata");
+            free(snap);
+            sleep(1);
+            continue;
+        }
+        snap->solved_count = solved_board_count(snap->solved);
+        snap->solved_max_score = solved_board_max_score(snap->solved);
+
+        // messaggi della partita serializzati una volta sola, riusati per ogni client
+        // (anche da login e richieste della matrice finche' lo snapshot e' corrente)
+        snap->matrix_frame = frame_create(MSG_MATRICE, snap->matrix_str, strlen(snap->matrix_str) + 1);
+        frame *start_frame = frame_create(MSG_OK, "Nuova partita iniziata", strlen("Nuova partita iniziata") + 1);
+        if (!snap->matrix_frame || !start_frame)
+        {
+            log_event("[ORCHESTRATOR] Memoria esaurita, partita non avviata");
+            frame_unref(start_frame);
+            frame_unref(snap->matrix_frame);
+            solved_board_free(snap->solved);
+            free(snap);
+            sleep(1);
+            continue;
         }
 
-        // invio classifica
+        // reset punteggi e parole usate: in pausa nessuna parola viene assegnata
+        // (dopo la fine partita snapshot_synchronize ha atteso le verifiche in corso)
         pthread_mutex_lock(&g_server.clients_mutex);
-        for (int i = 0; i < MAX_CLIENTS; i++)
+        for (client_info *c = g_server.active_head; c; c = c->next_active)
         {
-            if (g_server.clients[i].connected && g_server.clients[i].in_game)
+            pthread_mutex_lock(&c->state_mutex);
+            c->score = 0;
+            client_clear_words_locked(c);
+            c->rank_entry = NULL;
+            pthread_mutex_unlock(&c->state_mutex);
+        }
+        pthread_mutex_unlock(&g_server.clients_mutex);
+
+        // classifica vuota, con un bucket per ogni punteggio possibile nella matrice
+        if (leaderboard_reset(snap->solved_max_score) < 0)
+            log_event("[ORCHESTRATOR] Memoria esaurita, classifica non ridimensionata");
+
+        // inizio partita
+        snap->start_time = time(NULL);
+        snap->end_time = snap->start_time + g_server.game_duration;
+        snapshot_publish(snap);
+        log_event("[ORCHESTRATOR] Inizio partita");
+
+        // attende i lettori che vedono ancora la pausa, poi iscrive in classifica i client autenticati
+        // (chi ha fatto login a partita gia' pubblicata si e' iscritto da solo)
+        snapshot_synchronize();
+        pthread_mutex_lock(&g_server.clients_mutex);
+        for (client_info *c = g_server.active_head; c; c = c->next_active)
+        {
+            pthread_mutex_lock(&c->state_mutex);
+            c->in_game = true;
+            if (c->username[0] != '\0' && !c->rank_entry)
+                client_join_leaderboard_locked(c);
+            pthread_mutex_unlock(&c->state_mutex);
+        }
+        pthread_mutex_unlock(&g_server.clients_mutex);
+
+        // Invia notifica di inizio partita a tutti i client (senza lock globali)
+        client_ref *refs;
+        int n_refs = client_snapshot(&refs);
+        for (int i = 0; i < n_refs; i++)
+        {
+            if (refs[i].logged_in)
             {
-                send_message(g_server.clients[i].sockfd, MSG_PUNTI_FINALI, classifica, strlen(classifica) + 1);
-                g_server.clients[i].in_game = false;
+                client_send_frame_conn(refs[i].idx, refs[i].conn_id, start_frame);
+                client_send_frame_conn(refs[i].idx, refs[i].conn_id, snap->matrix_frame);
             }
         }
-        pthread_mutex_unlock(&g_server.clients_mutex);
+        free(refs);
+        frame_unref(start_frame);
+
+        log_event("[ORCHESTRATOR] Nuova partiata iniziata, durata %d secondi", g_server.game_duration);
+        log_event("[ORCHESTRATOR] Parole valide nella matrice: %d, punteggio massimo: %d", snap->solved_count, snap->solved_max_score);
+        event_log(EVENT_GAME_START, -1, 0, "ii", g_server.game_duration, snap->solved_max_score);
+        console_printf(CONSOLE_INFO, "[ORCHESTRATOR] Nuova partita iniziata, durata %d secondi (%d parole possibili, punteggio massimo %d)\n",
+                       g_server.game_duration, snap->solved_count, snap->solved_max_score);
+
+        // attesa della fine partita (timer, nessun polling); allo shutdown si chiude comunque la partita
+        live_version = 0;
+        live_top[0] = '\0';
+        phase_wait_until(snap->end_time, true);
+
+        // fine partita: da qui nessuna verifica vede la partita in corso; snapshot_synchronize
+        // attende quelle gia' iniziate, cosi' i punteggi raccolti sotto sono definitivi
+        publish_pause(snap);
+        snapshot_synchronize();
+
+        // la classifica e' aggiornata a ogni parola accettata (anche per i giocatori disconnessi
+        // durante la partita): dopo snapshot_synchronize e' definitiva, basta inviarla
+        int players = leaderboard_count();
+        log_event("[ORCHESTRATOR] Fine partita, %d giocatori in classifica", players);
+        event_log(EVENT_GAME_END, -1, 0, "i", players);
+
+        if (players == 0)
+        {
+            log_event("[ORCHESTRATOR] Nessun giocatore in classifica, salto invio classifica.");
+        }
+        else
+        {
+            // richiede la classifica allo scorer e aspetta che sia stata inviata
+            // (lo shutdown risveglia con broadcast)
+            pthread_mutex_lock(&ranking_mutex);
+            pthread_cleanup_push(mutex_cleanup, &ranking_mutex);
+            ranking_requested = true;
+            pthread_cond_broadcast(&ranking_cond);
+            while (!ranking_sent && !g_server.stop)
+                pthread_cond_wait(&ranking_cond, &ranking_mutex);
+            ranking_sent = false;
+            pthread_cleanup_pop(1);
+        }
+        // imposta il tempo di inizio della pausa (snap e' stato ritirato, si riparte dal corrente)
+        const game_snapshot *ended = snapshot_enter();
+        publish_pause(ended);
+        snapshot_exit();
+        time_t break_end = time(NULL) + g_server.break_time;
+
+        // pausa tra partite
+        console_printf(CONSOLE_INFO, "[ORCHESTRATOR] Partita terminata, pausa tra partite di %d secondi\n", g_server.break_time);
+        log_event("[ORCHESTRATOR] Inizio pausa di %d secondi", g_server.break_time);
+
+        phase_wait_until(break_end, false);
+    }
+    pthread_cleanup_pop(1);
+    return NULL;
+}
+
+// ======================= thread scorer =======================
+/*
+    scorer_thread:
+        invia la classifica finale di ogni partita
+        - attende la richiesta dell'orchestrator a fine partita (ranking_requested)
+        - la classifica e' gia' ordinata (leaderboard.h, aggiornata a ogni parola accettata):
+          viene solo serializzata in un messaggio MSG_PUNTI_FINALI di lunghezza variabile
+        - invia il messaggio ai client che hanno partecipato alla partita
+        - registra l'evento nel file di log e segnala l'invio all'orchestrator (ranking_sent)
+        - termina solo quando il server viene arrestato
+
+    si assume che:
+        - la condition variable sia correttamente inizializzata
+        - la struttura g_server sia correttamente inizializzata
+*/
+void *scorer_thread(void *arg)
+{
+    (void)arg;
+    // Abilita la cancellazione
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
+
+    while (!g_server.stop)
+    {
+        // attesa della fine partita, senza timeout
+        pthread_mutex_lock(&ranking_mutex);
+        pthread_cleanup_push(mutex_cleanup, &ranking_mutex);
+        while (!ranking_requested && !g_server.stop)
+            pthread_cond_wait(&ranking_cond, &ranking_mutex);
+        ranking_requested = false;
+        pthread_cleanup_pop(1);
+
+        // se il server e' in shutdown esce
+        if (g_server.stop)
+            break;
+
+        // classifica serializzata una volta sola per tutti i destinatari
+        size_t len = 0;
+        char *classifica = leaderboard_render(&len);
+        frame *ranking_frame = classifica ? frame_create(MSG_PUNTI_FINALI, classifica, len + 1) : NULL;
+        if (!classifica)
+            log_event("[SCORER] Memoria esaurita, classifica non inviata");
+
+        // invio classifica (senza lock globali)
+        client_ref *refs;
+        int n_refs = client_snapshot(&refs);
+        for (int i = 0; i < n_refs; i++)
+        {
+            client_info *c = g_server.clients[refs[i].idx];
+            pthread_mutex_lock(&c->state_mutex);
+            bool in_game = c->in_game && c->conn_id == refs[i].conn_id;
+            if (in_game)
+                c->in_game = false;
+            pthread_mutex_unlock(&c->state_mutex);
+            if (!in_game || !classifica)
+                continue;
+            if (ranking_frame)
+                client_send_frame_conn(refs[i].idx, refs[i].conn_id, ranking_frame);
+            else
+                client_send_conn(refs[i].idx, refs[i].conn_id, MSG_PUNTI_FINALI, classifica, len + 1);
+        }
+        free(refs);
+        frame_unref(ranking_frame);
+
+        if (classifica)
+        {
+            log_event("[SCORER] Parita terminata, classifica finale: \n%s", classifica);
+            console_printf(CONSOLE_INFO, "Partita termintata, classifica:\n%s\n", classifica);
+            free(classifica);
+        }
+
+        // Segnala all'orchestrator che la classifica è stata inviata
+        pthread_mutex_lock(&ranking_mutex);
+        ranking_sent = true;
+        pthread_cond_broadcast(&ranking_cond);
+        pthread_mutex_unlock(&ranking_mutex);
+    }
+
+    return NULL;
+}
+
+// ======================= disconnessione client =======================
+/*
+    client_disconnect:
+        chiude la connessione con il client 'idx' (se stava giocando resta in classifica
+        con il punteggio raggiunto e le parole proposte, riprese se rientra nella stessa partita),
+        chiude il socket e libera lo slot (comune alle due modalita')
+
+    si assume che:
+        - idx sia l'indice di un client connesso
+*/
+void client_disconnect(int idx)
+{
+    // la posizione in classifica resta fino a fine partita, lo slot non la aggiorna piu':
+    // l'elemento conserva le parole proposte (il prossimo client dello slot parte senza)
+    pthread_mutex_lock(&g_server.clients[idx]->state_mutex);
+    if (g_server.clients[idx]->rank_entry)
+    {
+        client_info *c = g_server.clients[idx];
+        lb_player_state state = {
+            .used_words = c->used_words,
+            .used_capacity = c->used_capacity,
+            .used_stamp = c->used_stamp,
+        };
+        leaderboard_detach(c->rank_entry, state);
+        c->used_words = NULL;
+        c->used_capacity = 0;
+        c->rank_entry = NULL;
+        log_event("[CLIENT] %s resta in classifica con %d punti", g_server.clients[idx]->username, g_server.clients[idx]->score);
+    }
+    pthread_mutex_unlock(&g_server.clients[idx]->state_mutex);
+    if (g_server.clients[idx]->username[0] != '\0')
+    {
+        event_log(EVENT_DISCONNECT, idx, g_server.clients[idx]->conn_id, "i", g_server.clients[idx]->score);
+        log_event("[SERVER] connessione terminata con utente: %s", g_server.clients[idx]->username);
+        console_printf(CONSOLE_INFO, "[SERVER] connessione terminata con utente: %s\n", g_server.clients[idx]->username);
+    }
+    else
+    {
+        log_event("[SERVER] connessione terminata con client collegato con socket %d", g_server.clients[idx]->sockfd);
+        console_printf(CONSOLE_INFO, "[SERVER] connessione terminata con client collegato con socket %d\n", g_server.clients[idx]->sockfd);
+    }
+    // chiusura socket, aggiornamento dello stato del client
+    // (sotto out_mutex: nessun altro thread puo' scrivere su un descrittore chiuso o riassegnato)
+    pthread_mutex_lock(&g_server.clients_mutex);
+    pthread_mutex_lock(&g_server.clients[idx]->out_mutex);
+    if (g_server.clients[idx]->sockfd >= 0)
+    {
+        close(g_server.clients[idx]->sockfd);
+        g_server.clients[idx]->sockfd = -1;
+    }
+    g_server.clients[idx]->out_len = 0;
+    g_server.clients[idx]->want_write = false;
+    g_server.clients[idx]->out_overflow = false;
+    pthread_mutex_unlock(&g_server.clients[idx]->out_mutex);
+    session_release(g_server.clients[idx]);
+    g_server.clients[idx]->username[0] = '\0';
+    // lo slot puo' essere gia' stato scollegato da broadcast_server_shutdown
+    if (g_server.clients[idx]->connected)
+        client_slot_release(g_server.clients[idx]);
+    pthread_mutex_unlock(&g_server.clients_mutex);
+    log_event("[CLIENT] Client terminato");
+}
+
+/*
+    client_thread_done:
+        segnala la fine di un thread di un client (modalita' thread per client), dopo
+        l'ultimo accesso al suo record: lo shutdown attende che non ne resti nessuno
+*/
+void client_thread_done()
+{
+    pthread_mutex_lock(&g_server.clients_mutex);
+    if (--g_server.client_threads == 0)
+        pthread_cond_broadcast(&g_server.client_threads_cond);
+    pthread_mutex_unlock(&g_server.clients_mutex);
+}
+
+
+// ======================= verifica parole =======================
+/*
+    client_record_word_locked:
+        registra la parola valida 'word_id' (indice in solved_board, 0..word_count-1) tra quelle
+        proposte dal client e ne aggiunge i punti: controllo e registrazione in tempo costante.
+        restituisce false (nessun punto) se la parola era gia' stata proposta
+        o se la memoria per registrarla e' esaurita
+
+    si assume che:
+        - il chiamante possieda c->state_mutex
+        - 0 <= word_id < word_count, con word_count il numero di parole valide della partita
+*/
+bool client_record_word_locked(client_info *c, int word_id, int word_count, int points)
+{
+    if (word_id >= c->used_capacity)
+    {
+        unsigned int *tmp = realloc(c->used_words, word_count * sizeof(unsigned int));
+        if (!tmp)
+        {
+            log_event("[DICTIONARY] Memoria esaurita, parola non registrata per '%s'", c->username);
+            return false;
+        }
+        memset(tmp + c->used_capacity, 0, (word_count - c->used_capacity) * sizeof(unsigned int));
+        c->used_words = tmp;
+        c->used_capacity = word_count;
+    }
+    if (c->used_words[word_id] == c->used_stamp)
+        return false;
+    // registra la parola e aggiorna il punteggio
+    c->used_words[word_id] = c->used_stamp;
+    c->score += points;
+    if (c->rank_entry)
+        leaderboard_add(c->rank_entry, points);
+    return true;
+}
+
+/*
+    validate_word:
+        verifica una parola proposta (partita in corso, presenza nella matrice e nel dizionario,
+        parola gia' proposta), aggiorna il punteggio del client e gli invia la risposta.
+        viene eseguita dai worker del pool (oppure direttamente dal thread di I/O).
+        la partita e' letta dallo snapshot corrente senza lock, punteggio e parole usate
+        sotto il lock del solo client; la risposta e' inviata senza lock
+
+    si assume che:
+        - job->client_idx sia un indice valido
+        - data sia la parola terminata da '\0' (job->word, oppure il messaggio se troppo lungo per il job)
+*/
+void validate_word(const word_job *job, const char *data)
+{
+    int idx = job->client_idx;
+    client_info *c = g_server.clients[idx];
+    if (!g_server.dictionary)
+    {
+        client_send_conn(idx, job->conn_id, MSG_ERR, "Dizionario non caricato", strlen("Dizionario non caricato") + 1);
+        return;
+    }
+
+    // controllo se la partita e' in corso, nel caso positivo non si accettano le parole;
+    // la sezione di lettura dura fino all'aggiornamento del punteggio: a fine partita
+    // l'orchestrator attende (snapshot_synchronize) che termini prima di raccogliere i punteggi
+    const game_snapshot *snap = snapshot_enter();
+    if (!snap->running)
+    {
+        snapshot_exit();
+        client_send_conn(idx, job->conn_id, MSG_TEMPO_ATTESA, "partita non avviata", strlen("partita non avviata") + 1);
+        return;
+    }
+
+    // verifica la parola: tutte le parole valide della matrice sono state
+    // calcolate a inizio partita, basta una ricerca nell'insieme
+    int points = 0;
+    int word_id = solved_board_find(snap->solved, data, &points);
+    if (word_id < 0)
+    {
+        snapshot_exit();
+        // solo per distinguere il messaggio di errore
+        if (!trie_search(g_server.dictionary, data))
+        {
+            client_send_conn(idx, job->conn_id, MSG_ERR, "Parola non presente in dizionario", strlen("Parola non presente in dizionario") + 1);
+            event_log(EVENT_WORD, idx, job->conn_id, "si", data, ESITO_NON_IN_DIZIONARIO);
+        }
+        else
+        {
+            client_send_conn(idx, job->conn_id, MSG_ERR, "Parola non presente in matrice", strlen("Parola non presente in matrice"));
+            event_log(EVENT_WORD, idx, job->conn_id, "si", data, ESITO_NON_IN_MATRICE);
+        }
+        return;
+    }
+
+    // verifica se e' ripetuta (il client puo' essersi disconnesso mentre il job era in coda)
+    pthread_mutex_lock(&c->state_mutex);
+    if (c->conn_id != job->conn_id)
+    {
+        pthread_mutex_unlock(&c->state_mutex);
+        snapshot_exit();
+        return;
+    }
+    bool repeated = !client_record_word_locked(c, word_id, snap->solved_count, points);
+    // posizione aggiornata dopo la parola, O(log M) (0 se il client non e' in classifica)
+    int rank = !repeated && c->rank_entry ? leaderboard_rank(c->rank_entry) : 0;
+    pthread_mutex_unlock(&c->state_mutex);
+    snapshot_exit();
+
+    char msg[1024];
+    if (repeated)
+    {
+        snprintf(msg, sizeof(msg), "Parola '%s' gia' proposta: 0 punti", data);
+        client_send_conn(idx, job->conn_id, MSG_PUNTI_PAROLA, msg, strlen(msg) + 1);
+        event_log(EVENT_WORD, idx, job->conn_id, "si", data, 0);
+    }
+    else
+    {
+        if (rank > 0)
+            snprintf(msg, sizeof(msg), "Parola '%s' accettata: %d punti (posizione in classifica: %d)", data, points, rank);
+        else
+            snprintf(msg, sizeof(msg), "Parola '%s' accettata: %d punti", data, points);
+        client_send_conn(idx, job->conn_id, MSG_PUNTI_PAROLA, msg, strlen(msg) + 1);
+        event_log(EVENT_WORD, idx, job->conn_id, "si", data, points);
+    }
+}
+
+/*
+    validate_words:
+        come validate_word, per un messaggio MSG_PAROLE con piu' parole: una sola sezione
+        di lettura dello snapshot e un solo lock del client per tutto il messaggio,
+        una sola risposta MSG_PUNTI_PAROLE con una riga "parola esito" per parola
+        (esito: punti assegnati, 0 se gia' proposta, ESITO_* se non valida)
+
+    si assume che:
+        - job->client_idx sia un indice valido
+        - words sia modificabile e terminato da '\0' (le parole sono separate sul posto)
+*/
+void validate_words(const word_job *job, char *words)
+{
+    int idx = job->client_idx;
+    client_info *c = g_server.clients[idx];
+    if (!g_server.dictionary)
+    {
+        client_send_conn(idx, job->conn_id, MSG_ERR, "Dizionario non caricato", strlen("Dizionario non caricato") + 1);
+        return;
+    }
+
+    // separazione delle parole: al piu' una ogni due caratteri del messaggio
+    size_t words_len = strlen(words);
+    char **list = malloc((words_len / 2 + 1) * sizeof(char *));
+    int *outcome = malloc((words_len / 2 + 1) * sizeof(int));
+    int *ids = malloc((words_len / 2 + 1) * sizeof(int));
+    if (!list || !outcome || !ids)
+    {
+        free(list);
+        free(outcome);
+        free(ids);
+        client_send_conn(idx, job->conn_id, MSG_ERR, "Memoria esaurita", strlen("Memoria esaurita") + 1);
+        return;
+    }
+    int n = 0;
+    char *saveptr;
+    for (char *w = strtok_r(words, " \t\n", &saveptr); w; w = strtok_r(NULL, " \t\n", &saveptr))
+        list[n++] = w;
+
+    const game_snapshot *snap = snapshot_enter();
+    if (!snap->running)
+    {
+        snapshot_exit();
+        free(list);
+        free(outcome);
+        free(ids);
+        client_send_conn(idx, job->conn_id, MSG_TEMPO_ATTESA, "partita non avviata", strlen("partita non avviata") + 1);
+        return;
+    }
 
-        log_event("[SCORER] Parita terminata, classifica finale: \n%s", classifica);
-        safe_printf("Partita termintata, classifica:\n%s\n", classifica);
+    // ricerca di tutte le parole nell'insieme delle parole valide, poi un solo aggiornamento del punteggio
+    for (int i = 0; i < n; i++)
+    {
+        ids[i] = solved_board_find(snap->solved, list[i], &outcome[i]);
+        if (ids[i] < 0)
+            outcome[i] = ESITO_NON_IN_MATRICE;
+    }
 
-        // Segnala all'orchestrator che la classifica è stata inviata
-        pthread_mutex_lock(&ranking_mutex);
-        ranking_sent = true;
-        pthread_cond_signal(&ranking_cond);
-        pthread_mutex_unlock(&ranking_mutex);
+    pthread_mutex_lock(&c->state_mutex);
+    if (c->conn_id != job->conn_id)
+    {
+        pthread_mutex_unlock(&c->state_mutex);
+        snapshot_exit();
+        free(list);
+        free(outcome);
+        free(ids);
+        return;
     }
+    for (int i = 0; i < n; i++)
+    {
+        if (ids[i] >= 0 && !client_record_word_locked(c, ids[i], snap->solved_count, outcome[i]))
+            outcome[i] = 0;
+    }
+    pthread_mutex_unlock(&c->state_mutex);
+    snapshot_exit();
+    free(ids);
 
-    return NULL;
+    // risposta: parola, spazio, esito (al piu' 11 caratteri), a capo
+    char *reply = malloc(words_len + (size_t)n * 13 + 1);
+    if (!reply)
+    {
+        free(list);
+        free(outcome);
+        client_send_conn(idx, job->conn_id, MSG_ERR, "Memoria esaurita", strlen("Memoria esaurita") + 1);
+        return;
+    }
+    size_t offset = 0;
+    reply[0] = '\0';
+    for (int i = 0; i < n; i++)
+    {
+        // solo per distinguere l'errore
+        if (outcome[i] == ESITO_NON_IN_MATRICE && !trie_search(g_server.dictionary, list[i]))
+            outcome[i] = ESITO_NON_IN_DIZIONARIO;
+        offset += sprintf(reply + offset, "%s %d\n", list[i], outcome[i]);
+        event_log(EVENT_WORD, idx, job->conn_id, "si", list[i], outcome[i]);
+    }
+    client_send_conn(idx, job->conn_id, MSG_PUNTI_PAROLE, reply, offset + 1);
+
+    free(reply);
+    free(list);
+    free(outcome);
 }
 
-// ======================= thread client =======================
 /*
-    client_thread:
-        gestisce la comunicazione con client
-        - all'inizio, imposta timeout per ricezione (SO_RCVTIMEO) per rilevare client inattivi
-        - elabora messaggi ricevuti dal client:
+    word_job_run:
+        funzione eseguita dai worker per ogni job
+*/
+void word_job_run(const word_job *job)
+{
+    if (job->words)
+    {
+        validate_words(job, job->words);
+        free(job->words);
+        return;
+    }
+    validate_word(job, job->word);
+}
+
+// ======================= gestione messaggi client =======================
+/*
+    handle_client_message:
+        elabora un messaggio ricevuto dal client 'idx' (comune alla modalita' thread-per-client e a quella epoll):
             + MSG_REGISTRA_UTENTE: registra un nuovo utente, se il nome non e' gia' in uso, e logga l'evento
             + MSG_LOGIN_UTENTE: verifica se l'utente e' registrato, e se e' registrato e non cancellato consente di riaccedere e logga l'evento
             + MSG_CANCELLA_UTENTE: cancella (deregistra) il nome utente e logga l'evento.
             + MSG_PAROLA: se la partita è in corso, verifica la parola (dizionario e matrice), calcola il punteggio
                       e logga l'evento; se la parola era già proposta, restituisce 0 punti.
+            + MSG_PAROLE: come MSG_PAROLA per piu' parole, con una sola risposta MSG_PUNTI_PAROLE.
             + MSG_MATRICE: invia la matrice corrente.
-    - Se la ricezione fallisce (incluso il timeout per inattività), il client viene disconnesso e loggato.
+        le risposte passano da client_send.
+        restituisce false se la connessione deve essere chiusa (MSG_SERVER_SHUTDOWN inviato dal client)
 
     si assume che:
-        - arg sia un puntatore ad un intero che rappresenta l'indice del client nella struttura g_server.clients
-        - il socket sia correttamente configurato per la ricezione dei messaggi
+        - idx sia l'indice di un client connesso
+        - data sia terminato da '\0'
 */
-void *client_thread(void *arg)
+bool handle_client_message(int idx, char type, char *data, unsigned int length)
 {
-    // Abilita la cancellazione
-    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
-    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
-
-    int idx = *(int *)arg;
-    free(arg);
-
-    int sockfd;
-    pthread_mutex_lock(&g_server.clients_mutex);
-    sockfd = g_server.clients[idx].sockfd;
-    pthread_mutex_unlock(&g_server.clients_mutex);
-
-    // impostazione gestore per SIGALRM
-    struct sigaction sa;
-    memset(&sa, 0, sizeof(sa));
-    sa.sa_handler = sigalarm_handler;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
-    sigaction(SIGALRM, &sa, NULL);
-
-    // impostazione timeout di ricezione sul socket, gestione client inattivi
-    struct timeval timeout;
-    timeout.tv_sec = g_server.disconnect_timeout;
-    timeout.tv_usec = 0;
-    if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout)) < 0)
+    (void)length;
+    // gestione di messaggi di tipo MSG_SERVER_SHUTDOWN inviati esplicitamente dal client
+    if (type == MSG_SERVER_SHUTDOWN)
     {
-        log_event("[CLIENT] setsockopt fallito: %s", strerror(errno));
-        close(sockfd);
-        pthread_exit(NULL);
+        console_printf(CONSOLE_DEBUG, "\n[SERVER] Shutdown: %s\n", data);
+        return false;
     }
-    time_t last_activity = time(NULL);
 
-    // buffer per messaggi
-    char type;
-    char data[BUFFER_SIZE];
-    unsigned int length = 0;
+    // Verifica se l'utente è loggato
+    bool is_logged_in = (g_server.clients[idx]->username[0] != '\0');
 
-    while (!g_server.stop)
+    // // Se non è loggato, consenti solo fine/resgitrzione/login
+    if (!is_logged_in)
     {
-        pthread_testcancel();
-        pthread_mutex_lock(&g_server.clients_mutex);
-        bool game_active = g_server.game_running;
-        pthread_mutex_unlock(&g_server.clients_mutex);
-
-        // se il gioco terminato e il punteggio non e' stato inviato, invialo alla coda
-        if (!game_active && !g_server.clients[idx].score_sent)
+        if (type != MSG_SERVER_SHUTDOWN &&
+            type != MSG_REGISTRA_UTENTE &&
+            type != MSG_LOGIN_UTENTE)
         {
-            push_score(g_server.clients[idx].username, g_server.clients[idx].score);
-            g_server.clients[idx].score_sent = true;
-            log_event("[CLIENT] Client %s: punteggio inviato alla coda", g_server.clients[idx].username);
+            // Comando non ammesso prima del login
+            client_send(idx, MSG_ERR,
+                         "Devi prima fare login, registrarti o chiudere la connessione (fine).",
+                         strlen("Devi prima fare login, registrarti o chiudere la connessione (fine).") + 1);
+            return true;
         }
+    }
 
-        // controllo periodico per inattivita'
-        if (difftime(time(NULL), last_activity) > g_server.disconnect_timeout)
+    // elabora messaggio
+    switch (type)
+    {
+    case MSG_REGISTRA_UTENTE:
+    {
+        console_printf(CONSOLE_DEBUG, "[SERVER] Ricevuto messaggio di registrazione per l'utente: %s\n", data);
+        log_event("[CLIENT] Ricevuta registrazione: %s", data);
+
+        // verifica nome utente
+        // (gli a capo sono esclusi anche perche' il journal degli utenti ha una riga per operazione)
+        if (strlen(data) > 10 || strpbrk(data, "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ") == NULL ||
+            strpbrk(data, "\r\n") != NULL)
         {
-            log_event("[CLIENT] Disconnessione per inattivita': %s", g_server.clients[idx].username);
-            send_message(sockfd, MSG_SERVER_SHUTDOWN, "Disconnessione per inattivita'", 30);
+            client_send(idx, MSG_ERR, "Nome utente non valido", strlen("Nome utente non valido") + 1);
             break;
         }
 
-        // ricezione messaggiod dal client
-        if (receive_message(sockfd, &type, data, &length) < 0)
+        // la risposta viene scelta sotto i lock e inviata dopo averli rilasciati
+        char reply_type = MSG_ERR;
+        const char *reply = NULL;
+
+        pthread_mutex_lock(&g_server.registered_mutex);
+
+        // Cerca utente esistente(anche cancellato)
+        user_state state = userstore_lookup(data);
+
+        // controlla se' e' gia' connesso
+        bool already_connected = session_contains(data);
+
+        // Gestione utente esistente
+        if (state != USER_ASSENTE)
         {
-            if (errno == EINTR)
+            if (state == USER_ATTIVO)
             {
-                // La read() è stata interrotta da SIGALRM: semplicemente riprova.
-                pthread_testcancel();
-                continue;
+                reply_type = MSG_ERR;
+                reply = "Nome utente già registrato";
             }
-            // controlla timeout di inattività (EAGAIN/EWOULDBLOCK), read su socket scaduta per timeout
-            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            else
+            {
+                // Riattiva l'utente solo se non è connesso altrove
+                if (already_connected)
+                {
+                    reply_type = MSG_ERR;
+                    reply = "Nome utente già in uso";
+                }
+                else if (userstore_register(data) < 0)
+                {
+                    reply_type = MSG_ERR;
+                    reply = "Registrazione non riuscita";
+                }
+                else
+                {
+                    reply_type = MSG_OK;
+                    reply = "Registrazione riattivata";
+                    log_event("[CLIENT] Utente riattivato: %s", data);
+                }
+            }
+        }
+        else
+        {
+            // Aggiungi nuovo utente
+            if (already_connected)
             {
-                send_message(sockfd, MSG_SERVER_SHUTDOWN, "Disconnessione per inattivita'", 30);
-                log_event("[CLIENT] Timeout di inattivita' per il client %s", g_server.clients[idx].username);
+                reply_type = MSG_ERR;
+                reply = "Nome utente già in uso";
             }
-            else if (errno == ENOTCONN)
+            else if (userstore_register(data) < 0)
             {
-                log_event("[CLIENT] Errore nella connessione con il client %s", g_server.clients[idx].username);
+                reply_type = MSG_ERR;
+                reply = "Registrazione non riuscita";
             }
             else
             {
-                log_event("[CLIENT] errore nella comunicazione: %s", strerror(errno));
+                reply_type = MSG_OK;
+                reply = "Registrazione completata";
+                log_event("[CLIENT] Nuovo utente registrato: %s", data);
             }
-            break;
-        }
-        else
-        {
-            last_activity = time(NULL);
         }
 
-        // gestione di messaggi di tipo MSG_SERVER_SHUTDOWN inviati esplicitamente dal client
-        if (type == MSG_SERVER_SHUTDOWN)
+        pthread_mutex_unlock(&g_server.registered_mutex);
+
+        client_send(idx, reply_type, reply, strlen(reply) + 1);
+        break;
+    }
+
+    case MSG_LOGIN_UTENTE:
+    {
+        console_printf(CONSOLE_DEBUG, "[SERVER] Ricevuto messaggio di login per l'utente: %s\n", data);
+        log_event("[CLIENT] Ricevuto login: %s", data);
+
+        // Controlla se il client è già autenticato
+        if (strlen(g_server.clients[idx]->username) > 0)
         {
-            safe_printf("\n[SERVER] Shutdown: %s\n", data);
+            client_send(idx, MSG_ERR, "Sei già autenticato", strlen("Sei già autenticato") + 1);
+            log_event("[CLIENT] Tentativo di login multiplo da &s", g_server.clients[idx]->username);
             break;
         }
 
-        // Verifica se l'utente è loggato
-        bool is_logged_in = (g_server.clients[idx].username[0] != '\0');
+        pthread_mutex_lock(&g_server.clients_mutex);
+        pthread_mutex_lock(&g_server.registered_mutex);
+
+        bool already_registered = userstore_lookup(data) == USER_ATTIVO;
+
+        // Controlla se già connesso, altrimenti associa il nome a questo client
+        bool in_use = already_registered && !session_claim(g_server.clients[idx], data);
 
-        // // Se non è loggato, consenti solo fine/resgitrzione/login
-        if (!is_logged_in)
+        // esito deciso sotto i lock, messaggi inviati dopo averli rilasciati
+        bool logged = false;
+        bool game_active = false;
+        frame *matrix_frame = NULL;
+        char time_str[128];
+
+        if (!already_registered)
         {
-            if (type != MSG_SERVER_SHUTDOWN &&
-                type != MSG_REGISTRA_UTENTE &&
-                type != MSG_LOGIN_UTENTE)
-            {
-                // Comando non ammesso prima del login
-                send_message(sockfd, MSG_ERR,
-                             "Devi prima fare login, registrarti o chiudere la connessione (fine).",
-                             strlen("Devi prima fare login, registrarti o chiudere la connessione (fine).") + 1);
-                continue;
-            }
+            log_event("[CLIENT] Tentativo di login all'utente %s non registrato", data);
         }
-
-        // elabora messaggio
-        switch (type)
+        else if (in_use)
         {
-        case MSG_REGISTRA_UTENTE:
+            log_event("[CLIENT] Tentativo di login all'utente %s gia' connesso", g_server.clients[idx]->username);
+        }
+        else
         {
-            pthread_mutex_lock(&g_server.clients_mutex);
-            pthread_mutex_lock(&g_server.registered_mutex);
-            safe_printf("[SERVER] Ricevuto messaggio di registrazione per l'utente: %s\n", data);
-            log_event("[CLIENT] Ricevuta registrazione: %s", data);
-
-            // verifica nome utente
-            if (strlen(data) > 10 || strpbrk(data, "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ") == NULL)
+            // login corretto
+            logged = true;
+            log_event("[CLIENT] Login effettuato con succeso, utente %s", data);
+            event_log(EVENT_LOGIN, idx, g_server.clients[idx]->conn_id, "s", data);
+
+            const game_snapshot *snap = snapshot_enter();
+            game_active = snap->running;
+            pthread_mutex_lock(&g_server.clients[idx]->state_mutex);
+            if (game_active)
             {
-                send_message(sockfd, MSG_ERR, "Nome utente non valido", strlen("Nome utente non valido") + 1);
-                pthread_mutex_unlock(&g_server.registered_mutex);
-                pthread_mutex_unlock(&g_server.clients_mutex);
-                break;
+                g_server.clients[idx]->in_game = true;
+                if (!g_server.clients[idx]->rank_entry)
+                    client_join_leaderboard_locked(g_server.clients[idx]);
+                // matrice (frame gia' pronto, condiviso) e tempo residuo
+                matrix_frame = frame_ref(snap->matrix_frame);
+                int remaining = (int)difftime(snap->end_time, time(NULL));
+                snprintf(time_str, sizeof(time_str), "%d", remaining);
             }
-
-            int existing_index = -1;
-            bool already_connected = false;
-
-            // Cerca utente esistente(anche cancellato)
-            for (int i = 0; i < g_server.registered_count; i++)
+            else
             {
-                if (strcmp(g_server.registered_users[i].username, data) == 0)
+                g_server.clients[idx]->score = 0;
+                client_clear_words_locked(g_server.clients[idx]);
+                g_server.clients[idx]->in_game = false;
+                // tempo attesa
+                int remaining_break = (int)difftime(snap->end_time, time(NULL));
+                if (remaining_break < 0)
                 {
-                    existing_index = i;
-                    break;
+                    remaining_break = 0;
                 }
-            }
 
-            // controlla se' e' gia' connesso
-            for (int i = 0; i < MAX_CLIENTS; i++)
-            {
-                if (g_server.clients[i].connected && strcmp(g_server.clients[i].username, data) == 0)
-                {
-                    already_connected = true;
-                    break;
-                }
+                // Costruisce una stringa CSV: primo campo il tempo di default, secondo il tempo rimanente
+                snprintf(time_str, sizeof(time_str), "pausa di %d secondi, e l'inizio della nuova partita tra %d", g_server.break_time, remaining_break);
             }
+            pthread_mutex_unlock(&g_server.clients[idx]->state_mutex);
+            snapshot_exit();
+        }
+
+        pthread_mutex_unlock(&g_server.registered_mutex);
+        pthread_mutex_unlock(&g_server.clients_mutex);
 
-            // Gestione utente esistente
-            if (existing_index != -1)
+        if (!already_registered)
+        {
+            client_send(idx, MSG_ERR, "Utente non registrato", strlen("Utente non registrato") + 1);
+        }
+        else if (in_use)
+        {
+            client_send(idx, MSG_ERR, "Utente gia' connesso", strlen("Utente gia' connesso") + 1);
+        }
+        else if (logged)
+        {
+            // conferma, matrice e tempo in un solo invio
+            msg_batch batch;
+            msg_batch_init(&batch);
+            msg_batch_add(&batch, MSG_OK, "Login effettuato", strlen("Login effettuato") + 1);
+            if (game_active)
             {
-                if (!g_server.registered_users[existing_index].deleted)
-                {
-                    send_message(sockfd, MSG_ERR, "Nome utente già registrato", 28);
-                }
-                else
-                {
-                    // Riattiva l'utente solo se non è connesso altrove
-                    if (already_connected)
-                    {
-                        send_message(sockfd, MSG_ERR, "Nome utente già in uso", 24);
-                    }
-                    else
-                    {
-                        g_server.registered_users[existing_index].deleted = false;
-                        send_message(sockfd, MSG_OK, "Registrazione riattivata", 25);
-                        log_event("[CLIENT] Utente riattivato: %s", data);
-                    }
-                }
+                msg_batch_add_raw(&batch, matrix_frame->data, matrix_frame->size);
+                msg_batch_add(&batch, MSG_TEMPO_PARTITA, time_str, strlen(time_str) + 1);
             }
             else
             {
-                // Aggiungi nuovo utente
-                if (already_connected)
-                {
-                    send_message(sockfd, MSG_ERR, "Nome utente già in uso", 24);
-                }
-                else if (g_server.registered_count >= MAX_REGISTERED_USERS)
-                {
-                    send_message(sockfd, MSG_ERR, "Limite utenti raggiunto", 24);
-                }
-                else
-                {
-                    strncpy(g_server.registered_users[g_server.registered_count].username, data, USERNAME_LEN - 1);
-                    g_server.registered_users[g_server.registered_count].deleted = false;
-                    g_server.registered_count++;
-                    send_message(sockfd, MSG_OK, "Registrazione completata", 25);
-                    log_event("[CLIENT] Nuovo utente registrato: %s", data);
-                }
+                msg_batch_add(&batch, MSG_MATRICE, time_str, strlen(time_str) + 1);
             }
+            client_send_batch(idx, &batch);
+            frame_unref(matrix_frame);
+        }
+        break;
+    }
+
+    case MSG_CANCELLA_UTENTE:
+    {
 
-            pthread_mutex_unlock(&g_server.registered_mutex);
-            pthread_mutex_unlock(&g_server.clients_mutex);
+        console_printf(CONSOLE_DEBUG, "[SERVER] Ricevuto comando di cancellazione per l'utente: %s\n", data);
+        log_event("[CLIENT] Ricevuta cancellazione registrazione: %s", data);
+        // Se il client sta tentando di cancellare se stesso mentre è loggato,
+        // rifiuta la richiesta
+        if (strcmp(g_server.clients[idx]->username, data) == 0)
+        {
+            client_send(idx, MSG_ERR, "Non puoi cancellare l'utente con cui sei loggato",
+                         strlen("Non puoi cancellare l'utente con cui sei loggato") + 1);
+            log_event("[CLIENT] Richiesta di cancellazione rifiutata: %s è loggato", data);
             break;
         }
+        pthread_mutex_lock(&g_server.registered_mutex);
+
+        bool trovato = userstore_delete(data);
 
-        case MSG_LOGIN_UTENTE:
+        pthread_mutex_unlock(&g_server.registered_mutex);
+
+        if (trovato)
+        {
+            client_send(idx, MSG_OK, "Utente cancellato", strlen("Utente cancellato") + 1);
+            log_event("[CLIENT] Utente cancellato: %s", data);
+        }
+        else
         {
-            safe_printf("[SERVER] Ricevuto messaggio di login per l'utente: %s\n", data);
-            log_event("[CLIENT] Ricevuto login: %s", data);
+            client_send(idx, MSG_ERR, "Utente non trovato", strlen("Utente non trovato") + 1);
+            log_event("[CLIENT] Tentativo di cancellazione utente %s non esistente", data);
+        }
+        break;
+    }
+    break;
 
-            // Controlla se il client è già autenticato
-            if (strlen(g_server.clients[idx].username) > 0)
-            {
-                send_message(sockfd, MSG_ERR, "Sei già autenticato", 20);
-                log_event("[CLIENT] Tentativo di login multiplo da &s", g_server.clients[idx].username);
+    case MSG_PAROLA:
+    {
+        console_printf(CONSOLE_DEBUG, "[SERVER] Ricevuto comando per parola: %s\n", data);
+
+        // la verifica viene eseguita da un worker; se il pool non e' attivo, la coda e' piena
+        // o la parola non entra nel job (non puo' comunque stare in una matrice) si verifica qui
+        word_job job;
+        job.client_idx = idx;
+        job.conn_id = g_server.clients[idx]->conn_id;
+        job.words = NULL;
+        if (strlen(data) < sizeof(job.word))
+        {
+            strcpy(job.word, data);
+            if (g_server.workers > 0 && workpool_try_submit(&job))
                 break;
-            }
+        }
+        validate_word(&job, data);
+        break;
+    }
 
-            pthread_mutex_lock(&g_server.clients_mutex);
-            pthread_mutex_lock(&g_server.registered_mutex);
+    case MSG_PAROLE:
+    {
+        // tutto il messaggio diventa un job: il worker verifica le parole in un solo passaggio
+        word_job job;
+        job.client_idx = idx;
+        job.conn_id = g_server.clients[idx]->conn_id;
+        job.word[0] = '\0';
+        job.words = g_server.workers > 0 ? strdup(data) : NULL;
+        if (job.words)
+        {
+            if (workpool_try_submit(&job))
+                break;
+            free(job.words);
+            job.words = NULL;
+        }
+        validate_words(&job, data);
+        break;
+    }
 
-            bool already_registered = false;
-            bool in_use = false;
+    case MSG_MATRICE:
+    {
+        console_printf(CONSOLE_DEBUG, "[SERVER] Ricevuto comando per matrice\n");
+        log_event("[CLIENT] Ricevuto comando matrice");
+
+        // copia dello stato di gioco dallo snapshot corrente, invio fuori dalla sezione di lettura
+        frame *matrix_frame = NULL;
+        char time_str[128];
+        const game_snapshot *snap = snapshot_enter();
+        bool game_active = snap->running;
+        if (game_active)
+        {
+            // matrice corrente, gia' serializzata nello snapshot: basta un riferimento
+            matrix_frame = frame_ref(snap->matrix_frame);
 
-            for (int i = 0; i < g_server.registered_count; i++)
+            // calcolo tempo residuo in secondi
+            int remaining = (int)difftime(snap->end_time, time(NULL));
+            snprintf(time_str, sizeof(time_str), "%d", remaining);
+        }
+        else
+        {
+            // !game_active
+            // calcola il tempo rimanente fino all'inizio della prossima partita
+            int remaining_break = (int)difftime(snap->end_time, time(NULL));
+            if (remaining_break < 0)
             {
-                if (strcmp(g_server.registered_users[i].username, data) == 0 &&
-                    !g_server.registered_users[i].deleted)
-                {
-                    already_registered = true;
-                    break;
-                }
+                remaining_break = 0;
             }
 
-            // Controlla se già connesso
-            if (already_registered)
-            {
-                for (int i = 0; i < MAX_CLIENTS; i++)
-                {
-                    if (g_server.clients[i].connected &&
-                        strcmp(g_server.clients[i].username, data) == 0)
-                    {
-                        in_use = true;
-                        break;
-                    }
-                }
-            }
+            // Costruisce una stringa CSV: primo campo il tempo di default, secondo il tempo rimanente
+            snprintf(time_str, sizeof(time_str), "pausa di %d secondi, e l'inizio della nuova partita tra %d", g_server.break_time, remaining_break);
+        }
+        snapshot_exit();
 
-            if (!already_registered)
-            {
-                send_message(sockfd, MSG_ERR, "Utente non registrato", 22);
-                log_event("[CLIENT] Tentativo di login all'utente %s non registrato", data);
-            }
-            else if (in_use)
-            {
-                send_message(sockfd, MSG_ERR, "Utente gia' connesso", 20);
-                log_event("[CLIENT] Tentativo di login all'utente %s gia' connesso", g_server.clients[idx].username);
-            }
-            else
-            {
-                // login corretto
-                strncpy(g_server.clients[idx].username, data, USERNAME_LEN - 1);
-                g_server.clients[idx].username[USERNAME_LEN - 1] = '\0';
-                send_message(sockfd, MSG_OK, "Login effettuato", 17);
-                log_event("[CLIENT] Login effettuato con succeso, utente %s", data);
+        // matrice e tempo in un solo invio
+        msg_batch batch;
+        msg_batch_init(&batch);
+        if (game_active)
+        {
+            msg_batch_add_raw(&batch, matrix_frame->data, matrix_frame->size);
+            msg_batch_add(&batch, MSG_TEMPO_PARTITA, time_str, strlen(time_str) + 1);
+        }
+        else
+        {
+            msg_batch_add(&batch, MSG_MATRICE, time_str, strlen(time_str) + 1);
+        }
+        client_send_batch(idx, &batch);
+        frame_unref(matrix_frame);
+    }
 
-                if (g_server.game_running)
-                {
-                    g_server.clients[idx].in_game = true;
-                    // invio matrice
-                    char matrix_buf[BUFFER_SIZE] = "";
-                    for (int i = 0; i < 16; i++)
-                    {
-
-                        strcat(matrix_buf, g_server.matrix[i]);
-                        if (i < 15)
-                            strcat(matrix_buf, " ");
-                    }
-                    send_message(sockfd, MSG_MATRICE, matrix_buf, (unsigned int)strlen(matrix_buf) + 1);
-                    // invio tempo residuo
-                    int remaining = g_server.game_duration - (int)difftime(time(NULL), g_server.game_start_time);
-                    char time_str[32];
-                    snprintf(time_str, sizeof(time_str), "%d", remaining);
-                    send_message(sockfd, MSG_TEMPO_PARTITA, time_str, strlen(time_str) + 1);
-                }
-                else
-                {
-                    g_server.clients[idx].score = 0;
-                    g_server.clients[idx].used_words_count = 0;
-                    g_server.clients[idx].score_sent = false;
-                    g_server.clients[idx].in_game = false;
-                    // invio tempo attesa
-                    int remaining_break = g_server.break_time - (int)difftime(time(NULL), g_server.break_start_time);
-                    if (remaining_break < 0)
-                    {
-                        remaining_break = 0;
-                    }
-
-                    // Costruisce una stringa CSV: primo campo il tempo di default, secondo il tempo rimanente
-                    char csv_str[128];
-                    snprintf(csv_str, sizeof(csv_str), "pausa di %d secondi, e l'inizio della nuova partita tra %d", g_server.break_time, remaining_break);
-                    send_message(sockfd, MSG_MATRICE, csv_str, strlen(csv_str) + 1);
-                }
-            }
+    break;
 
-            pthread_mutex_unlock(&g_server.registered_mutex);
-            pthread_mutex_unlock(&g_server.clients_mutex);
-            break;
+    case MSG_POST_BACHECA:
+    {
+        console_printf(CONSOLE_DEBUG, "[SERVER] Ricevuto comando per post bacheca\n");
+        log_event("[CLIENT] Ricevuto comando post bacheca");
+
+        // client invia un messaggio da postare sulla bacheca
+        pthread_mutex_lock(&bacheca_mutex);
+        BachecaMsg nuovo;
+        strncpy(nuovo.username, g_server.clients[idx]->username, USERNAME_LEN - 1);
+        strncpy(nuovo.message, data, 127);
+
+        // implementazione di una coda circolare
+        if (bacheca.count < MAX_BACHECA_MSG)
+        {
+            bacheca.messages[(bacheca.front + bacheca.count) % MAX_BACHECA_MSG] = nuovo;
+            bacheca.count++;
+        }
+        else
+        {
+            bacheca.messages[bacheca.front] = nuovo;
+            bacheca.front = (bacheca.front + 1) % MAX_BACHECA_MSG;
         }
+        pthread_mutex_unlock(&bacheca_mutex);
+        client_send(idx, MSG_OK, "Messaggio postato", strlen("Messaggio postato") + 1);
+        break;
+    }
 
-        case MSG_CANCELLA_UTENTE:
+    case MSG_SHOW_BACHECA:
+    {
+        console_printf(CONSOLE_DEBUG, "[SERVER] Ricevuto comando per show bacheca\n");
+        log_event("[CLIENT] Ricevuto comando show bacheca");
+
+        // copia il contenuto attuale della bacheca sotto lock, l'invio avviene dopo averlo
+        // rilasciato: un client lento non blocca post e show degli altri
+        char csv_buffer[2048] = {0};
+        pthread_mutex_lock(&bacheca_mutex);
+        for (int i = 0; i < bacheca.count; i++)
         {
+            int pos = (bacheca.front + i) % MAX_BACHECA_MSG;
+
+            // alterna nome e messaggio
+            strcat(csv_buffer, bacheca.messages[pos].username);
+            strcat(csv_buffer, ",");
+            strcat(csv_buffer, bacheca.messages[pos].message);
+            if (i < bacheca.count - 1)
+            {
+                strcat(csv_buffer, ",");
+            }
+        }
+        pthread_mutex_unlock(&bacheca_mutex);
+        client_send(idx, MSG_SHOW_BACHECA, csv_buffer, strlen(csv_buffer) + 1);
+        break;
+    }
+
+    case MSG_PUNTI_FINALI:
+    {
+        // il client ha ricevuto la classifica
+        console_printf(CONSOLE_DEBUG, "Classifica ricevuta per il client %s: %s\n", g_server.clients[idx]->username, data);
+        log_event("[CLIENT] Classifica ricetua per  %s: %s", g_server.clients[idx]->username, data);
+        break;
+    }
+    default:
+    {
+        client_send(idx, MSG_ERR, "Tipo messaggio sconosciuto", strlen("Tipo messaggio sconosciuto") + 1);
+    }
+    break;
+    }
+    return true;
+}
+
+// ======================= thread client =======================
+/*
+    client_thread:
+        gestisce la comunicazione con client
+        - all'inizio, imposta timeout per ricezione (SO_RCVTIMEO) per rilevare client inattivi
+          e per invio (SO_SNDTIMEO): un client che non legge non blocca i broadcast degli altri
+        - riceve i messaggi in modo bloccante e li passa a handle_client_message
+    - Se la ricezione fallisce (incluso il timeout per inattività), il client viene disconnesso e loggato.
+
+    si assume che:
+        - arg sia un puntatore ad un intero che rappresenta l'indice del client nella struttura g_server.clients
+        - il socket sia correttamente configurato per la ricezione dei messaggi
+*/
+void *client_thread(void *arg)
+{
+    // Abilita la cancellazione
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
+
+    int idx = *(int *)arg;
+    free(arg);
+    // nessun join: lo shutdown attende la fine dei thread dei client con client_threads
+    pthread_detach(pthread_self());
+
+    int sockfd;
+    pthread_mutex_lock(&g_server.clients[idx]->out_mutex);
+    sockfd = g_server.clients[idx]->sockfd;
+    pthread_mutex_unlock(&g_server.clients[idx]->out_mutex);
 
-            safe_printf("[SERVER] Ricevuto comando di cancellazione per l'utente: %s\n", data);
-            log_event("[CLIENT] Ricevuta cancellazione registrazione: %s", data);
-            // Se il client sta tentando di cancellare se stesso mentre è loggato,
-            // rifiuta la richiesta
-            if (strcmp(g_server.clients[idx].username, data) == 0)
-            {
-                send_message(sockfd, MSG_ERR, "Non puoi cancellare l'utente con cui sei loggato",
-                             strlen("Non puoi cancellare l'utente con cui sei loggato") + 1);
-                log_event("[CLIENT] Richiesta di cancellazione rifiutata: %s è loggato", data);
-                break;
-            }
-            pthread_mutex_lock(&g_server.registered_mutex);
+    // impostazione timeout di ricezione sul socket, gestione client inattivi
+    struct timeval timeout;
+    timeout.tv_sec = g_server.disconnect_timeout;
+    timeout.tv_usec = 0;
+    struct timeval send_timeout = {.tv_sec = CLIENT_SEND_TIMEOUT, .tv_usec = 0};
+    if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout)) < 0 ||
+        setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, (const char *)&send_timeout, sizeof(send_timeout)) < 0)
+    {
+        log_event("[CLIENT] setsockopt fallito: %s", strerror(errno));
+        client_disconnect(idx);
+        client_thread_done();
+        return NULL;
+    }
+    time_t last_activity = time(NULL);
 
-            bool trovato = false;
-            for (int i = 0; i < g_server.registered_count; i++)
-            {
-                if (strcmp(g_server.registered_users[i].username, data) == 0 &&
-                    !g_server.registered_users[i].deleted)
-                {
-                    g_server.registered_users[i].deleted = true;
-                    trovato = true;
-                    break;
-                }
-            }
+    // messaggi ricevuti: viste sul buffer del msg_reader del client
+    msg_reader *reader = &g_server.clients[idx]->reader;
+    char type;
+    char *data;
+    unsigned int length = 0;
 
-            pthread_mutex_unlock(&g_server.registered_mutex);
+    while (!g_server.stop)
+    {
+        pthread_testcancel();
 
-            if (trovato)
-            {
-                send_message(sockfd, MSG_OK, "Utente cancellato", 17);
-                log_event("[CLIENT] Utente cancellato: %s", data);
-            }
-            else
-            {
-                send_message(sockfd, MSG_ERR, "Utente non trovato", 18);
-                log_event("[CLIENT] Tentativo di cancellazione utente %s non esistente", data);
-            }
+        // controllo periodico per inattivita'
+        if (difftime(time(NULL), last_activity) > g_server.disconnect_timeout)
+        {
+            log_event("[CLIENT] Disconnessione per inattivita': %s", g_server.clients[idx]->username);
+            client_send(idx, MSG_SERVER_SHUTDOWN, "Disconnessione per inattivita'", strlen("Disconnessione per inattivita'") + 1);
             break;
         }
-        break;
 
-        case MSG_PAROLA:
+        // ricezione messaggiod dal client
+        if (msg_reader_receive(reader, &type, &data, &length) < 0)
         {
-            safe_printf("[SERVER] Ricevuto comando per parola: %s\n", data);
-            log_event("[CLIENT] Ricevuta parola: %s", data);
-            if (!g_server.dictionary)
-            {
-                send_message(sockfd, MSG_ERR, "Dizionario non caricato", strlen("Dizionario non caricato") + 1);
-                break;
-            }
-            // controllo se la partita e' in corso, nel caso positivo non si accettano le parole
-            pthread_mutex_lock(&g_server.clients_mutex);
-            bool game_active = g_server.game_running;
-            bool is_connected = g_server.clients[idx].connected;
-            pthread_mutex_unlock(&g_server.clients_mutex);
-
-            if (!is_connected)
-                break;
-            if (!game_active)
-            {
-                send_message(sockfd, MSG_TEMPO_ATTESA, "partita non avviata", strlen("partita non avviata") + 1);
-                break;
-            }
-
-            // verifica la parola:
-            // 1) controllo dizionario
-            if (!trie_search(g_server.dictionary, data))
+            if (errno == EINTR)
             {
-                send_message(sockfd, MSG_ERR, "Parola non presente in dizionario", strlen("Parola non presente in dizionario") + 1);
-                break;
+                // read() interrotta da un segnale: semplicemente riprova.
+                pthread_testcancel();
+                continue;
             }
-
-            // 2) controllo presenza nella matrice
-            if (!is_word_in_matrix(g_server.matrix, data))
+            // controlla timeout di inattività (EAGAIN/EWOULDBLOCK), read su socket scaduta per timeout
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
             {
-                send_message(sockfd, MSG_ERR, "Parola non presente in matrice", strlen("Parola non presente in matrice"));
-                break;
+                client_send(idx, MSG_SERVER_SHUTDOWN, "Disconnessione per inattivita'", strlen("Disconnessione per inattivita'") + 1);
+                log_event("[CLIENT] Timeout di inattivita' per il client %s", g_server.clients[idx]->username);
             }
-
-            // 3) calcolo punteggio (numero di lettere "logiche", con Qu = 1)
-            int points = count_letters(data);
-
-            // 4) verifica se e' ripetuta
-            pthread_mutex_lock(&g_server.clients_mutex);
-            bool repeated = false;
-            for (int i = 0; i < g_server.clients[idx].used_words_count; i++)
+            else if (errno == ENOTCONN)
             {
-                if (strcmp(g_server.clients[idx].used_words[i], data) == 0)
-                {
-                    repeated = true;
-                    break;
-                }
+                log_event("[CLIENT] Errore nella connessione con il client %s", g_server.clients[idx]->username);
             }
-            if (repeated)
+            else if (errno == EMSGSIZE)
             {
-                pthread_mutex_unlock(&g_server.clients_mutex);
-                char msg[1024];
-                snprintf(msg, sizeof(msg), "Parola '%s' gia' proposta: 0 punti", data);
-                send_message(sockfd, MSG_PUNTI_PAROLA, msg, strlen(msg) + 1);
-                log_event("[DICTIONARY] Parola ripetuta da '%s' : %s", g_server.clients[idx].username, data);
+                log_event("[CLIENT] frame troppo lungo dal client in slot %d", idx);
+                client_reject_too_long(idx);
             }
             else
             {
-                // registra la parola e aggiorna il punteggio
-                if (g_server.clients[idx].used_words_count < MAX_WORDS_USED)
-                {
-                    strncpy(g_server.clients[idx].used_words[g_server.clients[idx].used_words_count], data, sizeof(g_server.clients[idx].used_words[g_server.clients[idx].used_words_count]) - 1);
-                    // terminatore
-                    g_server.clients[idx].used_words[g_server.clients[idx].used_words_count][sizeof(g_server.clients[idx].used_words[g_server.clients[idx].used_words_count]) - 1] = '\0';
-                    g_server.clients[idx].used_words_count++;
-                }
-                g_server.clients[idx].score += points;
-                pthread_mutex_unlock(&g_server.clients_mutex);
-                char msg[1024];
-                snprintf(msg, sizeof(msg), "Parola '%s' accettata: %d punti", data, points);
-                send_message(sockfd, MSG_PUNTI_PAROLA, msg, strlen(msg) + 1);
-                log_event("[DICTIONARY] Utente '%s' ha inviato parola '%s' assegnado %d punti", g_server.clients[idx].username, data, points);
+                log_event("[CLIENT] errore nella comunicazione: %s", strerror(errno));
             }
             break;
         }
-
-        case MSG_MATRICE:
+        else
         {
-            safe_printf("[SERVER] Ricevuto comando per matrice\n");
-            log_event("[CLIENT] Ricevuto comando matrice");
+            last_activity = time(NULL);
+        }
 
-            pthread_mutex_lock(&g_server.clients_mutex);
-            bool game_active = g_server.game_running;
-            pthread_mutex_unlock(&g_server.clients_mutex);
+        if (!handle_client_message(idx, type, data, length))
+            break;
+    }
 
-            if (game_active)
-            {
-                // invio della matrice corrente come stringa, 16 celle separate da spazio
-                char matrix_buf[BUFFER_SIZE] = "";
-                for (int i = 0; i < 16; i++)
-                {
-                    strcat(matrix_buf, g_server.matrix[i]);
-                    if (i < 15)
-                        strcat(matrix_buf, " ");
-                }
-                send_message(sockfd, MSG_MATRICE, matrix_buf, (unsigned int)strlen(matrix_buf) + 1);
+    client_disconnect(idx);
+    client_thread_done();
+    return NULL;
+}
 
-                // calcolo tempo residuo in secondi
-                int remaining = g_server.game_duration - (int)difftime(time(NULL), g_server.game_start_time);
-                char time_str[32];
-                snprintf(time_str, sizeof(time_str), "%d", remaining);
+// ======================= reactor epoll =======================
+/*
+    client_slot_open:
+        cerca uno slot libero e registra il nuovo client (comune alle due modalita').
+        se il server e' pieno invia l'errore al client e chiude la connessione
+        restituisce l'indice dello slot oppure -1
 
-                // invio
-                send_message(sockfd, MSG_TEMPO_PARTITA, time_str, strlen(time_str) + 1);
-            }
-            else
-            {
-                // !game_active
-                // calcola il tempo rimanente fino all'inizio della prossima partita
-                int remaining_break = g_server.break_time - (int)difftime(time(NULL), g_server.break_start_time);
-                if (remaining_break < 0)
-                {
-                    remaining_break = 0;
-                }
+    si assume che:
+        - newsock sia un socket connesso appena accettato
+*/
+int client_slot_open(int newsock)
+{
+    // risposte brevi: inviate subito, senza attendere l'ACK del segmento precedente
+    if (set_tcp_nodelay(newsock) < 0)
+        log_event("[ACCEPT] TCP_NODELAY non impostato: %s", strerror(errno));
 
-                // Costruisce una stringa CSV: primo campo il tempo di default, secondo il tempo rimanente
-                char csv_str[128];
-                snprintf(csv_str, sizeof(csv_str), "pausa di %d secondi, e l'inizio della nuova partita tra %d", g_server.break_time, remaining_break);
-                send_message(sockfd, MSG_MATRICE, csv_str, strlen(csv_str) + 1);
-            }
-        }
+    pthread_mutex_lock(&g_server.clients_mutex);
+    client_info *c = client_slot_alloc();
+    if (!c)
+    {
+        pthread_mutex_unlock(&g_server.clients_mutex);
+        send_message(newsock, MSG_ERR, "Server pieno", strlen("Server pieno") + 1);
+        close(newsock);
+        log_event("[ACCEPT] Connessione rifiutata: server pieno");
+        return -1;
+    }
+    // conn_id cambia sotto out_mutex e state_mutex: chi controlla la connessione con
+    // uno dei due lock non puo' confondere il nuovo client con il precedente
+    pthread_mutex_lock(&c->state_mutex);
+    pthread_mutex_lock(&c->out_mutex);
+    c->sockfd = newsock;
+    c->conn_id++;
+    msg_reader_reset(&c->reader, newsock);
+    c->out_len = 0;
+    c->want_write = false;
+    c->out_overflow = false;
+    pthread_mutex_unlock(&c->out_mutex);
+    c->score = 0;
+    client_clear_words_locked(c);
+    c->rank_entry = NULL;
+    c->in_game = false;
+    pthread_mutex_unlock(&c->state_mutex);
+    c->username[0] = '\0';
+    c->last_activity = time(NULL);
+    client_link(c);
+    pthread_mutex_unlock(&g_server.clients_mutex);
+    return c->idx;
+}
 
-        break;
+/*
+    reactor_accept:
+        accetta tutte le connessioni in attesa sul socket in ascolto (non bloccante)
+        e le registra nell'istanza epoll con l'indice dello slot come chiave
 
-        case MSG_POST_BACHECA:
+    si assume che:
+        - il socket in ascolto sia non bloccante e registrato in g_server.epoll_fd
+*/
+void reactor_accept()
+{
+    while (!g_server.stop)
+    {
+        int newsock = accept4(g_server.server_sockfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (newsock < 0)
         {
-            safe_printf("[SERVER] Ricevuto comando per post bacheca\n");
-            log_event("[CLIENT] Ricevuto comando post bacheca");
-
-            // client invia un messaggio da postare sulla bacheca
-            pthread_mutex_lock(&bacheca_mutex);
-            BachecaMsg nuovo;
-            strncpy(nuovo.username, g_server.clients[idx].username, USERNAME_LEN - 1);
-            strncpy(nuovo.message, data, 127);
-
-            // implementazione di una coda circolare
-            if (bacheca.count < MAX_BACHECA_MSG)
-            {
-                bacheca.messages[(bacheca.front + bacheca.count) % MAX_BACHECA_MSG] = nuovo;
-                bacheca.count++;
-            }
-            else
-            {
-                bacheca.messages[bacheca.front] = nuovo;
-                bacheca.front = (bacheca.front + 1) % MAX_BACHECA_MSG;
-            }
-            pthread_mutex_unlock(&bacheca_mutex);
-            send_message(sockfd, MSG_OK, "Messaggio postato", strlen("Messaggio postato") + 1);
-            break;
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                log_event("[ACCEPT] accept fallita: %s", strerror(errno));
+            return;
         }
+        log_event("[ACCEPT] Nuova connessione accettata");
+        console_printf(CONSOLE_INFO, "[SERVER] nuovo client connesso \n");
+
+        int idx = client_slot_open(newsock);
+        if (idx < 0)
+            continue;
 
-        case MSG_SHOW_BACHECA:
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u32 = (uint32_t)idx;
+        if (epoll_ctl(g_server.epoll_fd, EPOLL_CTL_ADD, newsock, &ev) < 0)
         {
-            safe_printf("[SERVER] Ricevuto comando per show bacheca\n");
-            log_event("[CLIENT] Ricevuto comando show bacheca");
+            log_event("[ACCEPT] epoll_ctl fallita per client in slot %d: %s", idx, strerror(errno));
+            client_disconnect(idx);
+            continue;
+        }
+        log_event("[ACCEPT] Client in slot %d registrato nel reactor", idx);
+    }
+}
 
-            // invia al client il contenuto attuale della bachca
-            pthread_mutex_lock(&bacheca_mutex);
-            char csv_buffer[2048] = {0};
-            for (int i = 0; i < bacheca.count; i++)
-            {
-                int pos = (bacheca.front + i) % MAX_BACHECA_MSG;
+/*
+    reactor_read:
+        legge i dati disponibili dal client 'idx' e gestisce tutti i frame completi ricevuti;
+        un frame incompleto resta nel msg_reader del client fino al prossimo evento.
+        restituisce false se il client va disconnesso (chiusura, errore, frame non valido o MSG_SERVER_SHUTDOWN)
 
-                // alterna nome e messaggio
-                strcat(csv_buffer, bacheca.messages[pos].username);
-                strcat(csv_buffer, ",");
-                strcat(csv_buffer, bacheca.messages[pos].message);
-                if (i < bacheca.count - 1)
-                {
-                    strcat(csv_buffer, ",");
-                }
-            }
-            send_message(sockfd, MSG_SHOW_BACHECA, csv_buffer, strlen(csv_buffer) + 1);
-            pthread_mutex_unlock(&bacheca_mutex);
-            break;
+    si assume che:
+        - il client sia connesso e il socket sia non bloccante
+*/
+bool reactor_read(int idx)
+{
+    client_info *c = g_server.clients[idx];
+    for (;;)
+    {
+        ssize_t n = msg_reader_fill(&c->reader);
+        if (n == 0)
+            return false;
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+            log_event("[CLIENT] errore nella comunicazione: %s", strerror(errno));
+            return false;
         }
-
-        case MSG_PUNTI_FINALI:
+        c->last_activity = time(NULL);
+
+        // estrae i frame completi (viste sul buffer, nessuna copia)
+        char type;
+        char *data;
+        unsigned int length;
+        int ret;
+        while ((ret = msg_reader_next(&c->reader, &type, &data, &length)) > 0)
         {
-            // il client ha ricevuto la classifica
-            safe_printf("Classifica ricevuta per il client %s: %s\n", g_server.clients[idx].username, data);
-            log_event("[CLIENT] Classifica ricetua per  %s: %s", g_server.clients[idx].username, data);
-            break;
+            if (!handle_client_message(idx, type, data, length))
+                return false;
         }
-        default:
+        if (ret < 0)
         {
-            send_message(sockfd, MSG_ERR, "Tipo messaggio sconosciuto", strlen("Tipo messaggio sconosciuto") + 1);
+            log_event("[CLIENT] frame troppo lungo dal client in slot %d", idx);
+            client_reject_too_long(idx);
+            return false;
         }
-        break;
+    }
+}
+
+/*
+    reactor_sweep:
+        controllo periodico del reactor (al posto di SO_RCVTIMEO della modalita' thread):
+        disconnette i client inattivi da piu' di disconnect_timeout secondi
+        (i punteggi di fine partita li raccoglie l'orchestrator)
+*/
+void reactor_sweep()
+{
+    time_t now = time(NULL);
+
+    // in modalita' epoll la lista dei client attivi viene modificata solo dal reactor:
+    // la si puo' scorrere senza clients_mutex, salvando il successivo prima di una disconnessione
+    client_info *next;
+    for (client_info *c = g_server.active_head; c; c = next)
+    {
+        next = c->next_active;
+
+        if (difftime(now, c->last_activity) > g_server.disconnect_timeout)
+        {
+            log_event("[CLIENT] Timeout di inattivita' per il client %s", c->username);
+            client_send(c->idx, MSG_SERVER_SHUTDOWN, "Disconnessione per inattivita'", strlen("Disconnessione per inattivita'") + 1);
+            client_disconnect(c->idx);
         }
     }
+}
+
+/*
+    reactor_run:
+        loop principale della modalita' epoll: un solo thread gestisce accept, letture e
+        scritture differite di tutti i client; orchestrator e scorer restano thread separati
+        e scrivono ai client tramite client_send.
+        esce quando viene impostato g_server.stop (SIGINT)
 
-    // invio finale del punteggio, se non gia' fatto
-    if (!g_server.clients[idx].score_sent)
+    si assume che:
+        - il socket in ascolto sia stato creato e messo in ascolto correttamente
+*/
+int reactor_run()
+{
+    g_server.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (g_server.epoll_fd < 0)
     {
-        push_score(g_server.clients[idx].username, g_server.clients[idx].score);
-        g_server.clients[idx].score_sent = true;
-        log_event("[CLIENT] Punteggio finale inviato per %s", g_server.clients[idx].username);
+        perror("epoll_create1");
+        return -1;
     }
-    if (g_server.clients[idx].username && g_server.clients[idx].username[0] != '\0')
+
+    int flags = fcntl(g_server.server_sockfd, F_GETFL, 0);
+    fcntl(g_server.server_sockfd, F_SETFL, flags | O_NONBLOCK);
+
+    // il socket in ascolto usa una chiave fuori dall'intervallo degli slot
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = UINT32_MAX;
+    if (epoll_ctl(g_server.epoll_fd, EPOLL_CTL_ADD, g_server.server_sockfd, &ev) < 0)
     {
-        log_event("[SERVER] connessione terminata con utente: %s", g_server.clients[idx].username);
-        safe_printf("[SERVER] connessione terminata con utente: %s\n", g_server.clients[idx].username);
+        perror("epoll_ctl listen");
+        return -1;
     }
-    else
+    log_event("[SYSTEM] Reactor epoll avviato");
+
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+    time_t last_sweep = time(NULL);
+    while (!g_server.stop)
     {
-        log_event("[SERVER] connessione terminata con client collegato con socket %d", g_server.clients[idx].sockfd);
-        safe_printf("[SERVER] connessione terminata con client collegato con socket %d\n", g_server.clients[idx].sockfd);
+        int n = epoll_wait(g_server.epoll_fd, events, REACTOR_MAX_EVENTS, 1000);
+        if (n < 0 && errno != EINTR)
+        {
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            uint32_t key = events[i].data.u32;
+            if (key == UINT32_MAX)
+            {
+                reactor_accept();
+                continue;
+            }
+
+            int idx = (int)key;
+            client_info *c = g_server.clients[idx];
+            // il client puo' essere stato chiuso da un evento precedente dello stesso giro
+            if (!c->connected)
+                continue;
+
+            bool keep = !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (keep && (events[i].events & EPOLLIN))
+                keep = reactor_read(idx);
+            if (keep && (events[i].events & EPOLLOUT))
+            {
+                pthread_mutex_lock(&c->out_mutex);
+                keep = c->sockfd >= 0 && client_flush_locked(c) == 0;
+                pthread_mutex_unlock(&c->out_mutex);
+            }
+            // client troppo lento a ricevere (buffer di uscita oltre CLIENT_OUT_MAX)
+            if (keep && c->out_overflow)
+            {
+                log_event("[CLIENT] Client in slot %d troppo lento, disconnesso", idx);
+                keep = false;
+            }
+            if (!keep && c->connected)
+                client_disconnect(idx);
+        }
+
+        if (time(NULL) != last_sweep)
+        {
+            last_sweep = time(NULL);
+            reactor_sweep();
+        }
     }
-    // chiusura socket, aggiornamento dello stato del client
-    close(sockfd);
 
-    pthread_mutex_lock(&g_server.clients_mutex);
-    g_server.clients[idx].connected = false;
-    g_server.clients[idx].username[0] = '\0';
-    pthread_mutex_unlock(&g_server.clients_mutex);
-    log_event("[CLIENT] Client terminato");
-    return NULL;
+    close(g_server.epoll_fd);
+    g_server.epoll_fd = -1;
+    console_printf(CONSOLE_INFO, "[SERVER] Uscita dal reactor \n");
+    log_event("[SYSTEM] Server: uscita dal reactor epoll");
+    return 0;
 }
 
 // ======================= FUNZIONI PUBBLICHE DEL SERVER =======================
@@ -1166,16 +2319,20 @@ void *client_thread(void *arg)
         inizializzazione struttura globale del server:
         - imposta parametri di gioco e disconnessione
         - inizializza client mutex
-        - carica dizionario in un trie
+        - carica dizionario in un trie (o in un DAWG minimo se dict_dawg),
+          oppure mappa direttamente l'immagine binaria se dict_file e' un'immagine
         - se specificato, apre il file delle matrici(altrimenti generazione casuale)
         - imposta seed, per numeri pseudocasuali
         - generazione matrice iniziale
         - apertura file di log
         - crea e configura il socket in ascolto
+        - se use_epoll, le connessioni saranno gestite da un unico reactor epoll invece che da un thread per client
+        - workers: numero di thread per la verifica delle parole (0 = verifica nel thread di I/O)
+        - max_clients: numero massimo di connessioni contemporanee
 
     si assume che:
         - il server non sia gia' inizializzato
-        - i parametri passati (port, game_duration_sec, break_time_sec, dict_file, matrix_file, seed, disconnect_timeout_sec) siano validi e nel formato corretto
+        - i parametri passati (port, game_duration_sec, break_time_sec, dict_file, matrix_file, seed, disconnect_timeout_sec, dict_dawg, board_dim, use_epoll, workers, max_clients) siano validi e nel formato corretto
 */
 int server_init(
     int port,
@@ -1184,7 +2341,13 @@ int server_init(
     const char *dict_file,
     const char *matrix_file,
     int seed,
-    int disconnect_timeout_sec)
+    int disconnect_timeout_sec,
+    bool dict_dawg,
+    int board_dim,
+    bool use_epoll,
+    int workers,
+    int max_clients,
+    const char *users_file)
 {
     struct sigaction sa;
     memset(&sa, 0, sizeof(sa));
@@ -1198,28 +2361,50 @@ int server_init(
         exit(EXIT_FAILURE);
     }
 
-    // reset g_server, inizializzazione parametri
+    // reset g_server, inizializzazione parametri (il nome e' gia' stato impostato da server_set_name)
+    char server_name[sizeof(g_server.server_name)];
+    memcpy(server_name, g_server.server_name, sizeof(server_name));
     memset(&g_server, 0, sizeof(g_server));
+    memcpy(g_server.server_name, server_name, sizeof(server_name));
     g_server.port = port;
     g_server.game_duration = game_duration_sec;
     g_server.break_time = break_time_sec;
     g_server.stop = false;
-    g_server.game_running = false;
     g_server.seed = seed;
+    g_server.board_dim = board_dim;
+    g_server.use_epoll = use_epoll;
+    g_server.workers = workers;
+    g_server.epoll_fd = -1;
 
     // impostazione timeout di disconnessione per inattivita'
     g_server.disconnect_timeout = disconnect_timeout_sec;
 
     // inizializzazione mutex
     pthread_mutex_init(&g_server.clients_mutex, NULL);
+    pthread_cond_init(&g_server.client_threads_cond, NULL);
     pthread_mutex_init(&g_server.registered_mutex, NULL);
-    pthread_mutex_init(&g_server.log_mutex, NULL);
+    for (int i = 0; i < SESSION_STRIPES; i++)
+        pthread_mutex_init(&g_server.session_locks[i], NULL);
+
+    // tabella dei client: solo i puntatori, i record vengono allocati alla prima connessione
+    g_server.max_clients = max_clients;
+    g_server.free_slot = -1;
+    g_server.clients = calloc(max_clients, sizeof(client_info *));
+    // mappa delle sessioni: almeno due bucket per client, potenza di 2
+    g_server.session_buckets = SESSION_STRIPES;
+    while (g_server.session_buckets < 2 * (unsigned int)max_clients)
+        g_server.session_buckets *= 2;
+    g_server.sessions = calloc(g_server.session_buckets, sizeof(client_info *));
+    if (!g_server.clients || !g_server.sessions)
+    {
+        perror("calloc clients");
+        exit(EXIT_FAILURE);
+    }
 
-    // apertura file di log in modalita' append
-    g_server.log_fp = fopen("paroliere.log", "a");
-    if (g_server.log_fp == NULL)
+    // apertura dei file di log (testo ed eventi) in modalita' append e avvio del thread writer
+    if (asynclog_open(LOG_FILE, EVENT_FILE, g_server.server_name) < 0)
     {
-        perror("fopen log");
+        perror("apertura log");
         exit(EXIT_FAILURE);
     }
     log_event("[SYSTEM] File di log aperto");
@@ -1228,9 +2413,13 @@ int server_init(
     if (dict_file == NULL)
     {
         // default se non specificato file per dizionario
-        dict_file = "resources/dictionary.txt";
+        dict_file = DEFAULT_DICT_FILE;
     }
-    g_server.dictionary = load_dictionary_trie(dict_file);
+    bool dict_image = dictionary_is_image(dict_file);
+    if (dict_image)
+        g_server.dictionary = load_dictionary_image(dict_file);
+    else
+        g_server.dictionary = dict_dawg ? load_dictionary_dawg(dict_file) : load_dictionary_trie(dict_file);
 
     if (!g_server.dictionary)
     {
@@ -1238,7 +2427,15 @@ int server_init(
         exit(EXIT_FAILURE); // termina il server
     }
 
-    log_event("[SYSTEM] Dizionario caricato da %s", dict_file);
+    log_event("[SYSTEM] Dizionario caricato da %s (%s)", dict_file, dict_image ? "immagine" : (dict_dawg ? "DAWG" : "trie"));
+
+    // utenti registrati nelle esecuzioni precedenti
+    if (userstore_open(users_file) < 0)
+    {
+        fprintf(stderr, "ERROR: impossibile aprire il journal degli utenti %s\n", users_file);
+        exit(EXIT_FAILURE);
+    }
+    log_event("[SYSTEM] Utenti registrati caricati da %s: %d", users_file, userstore_active_count());
 
     // se e' stato specificato un file di matrici, lo apre
     if (matrix_file != NULL)
@@ -1255,14 +2452,23 @@ int server_init(
         }
         log_event("[SYSTEM] File matrici aperto: %s", matrix_file);
     }
-    else
+
+    // scadenze delle fasi di gioco, tick della classifica parziale, risveglio allo shutdown
+    // e cambi di verbosita' per l'orchestrator
+    g_server.phase_timer_fd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC);
+    g_server.stop_event_fd = eventfd(0, EFD_CLOEXEC);
+    g_server.live_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    g_server.verbosity_event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (g_server.phase_timer_fd < 0 || g_server.stop_event_fd < 0 || g_server.live_timer_fd < 0 ||
+        g_server.verbosity_event_fd < 0)
     {
-        // generazione casuale di una matrice, placeholader
-        unsigned int effective_seed = (g_server.seed >= 0) ? (unsigned int)g_server.seed : (unsigned int)time(NULL);
-        generate_matrix(g_server.matrix, effective_seed);
-        log_event("[SYSTEM] Matrice generata casualmente (seed=%u)", effective_seed);
+        perror("timerfd/eventfd");
+        exit(EXIT_FAILURE);
     }
 
+    // snapshot iniziale (pausa senza matrice) finche' l'orchestrator non avvia la prima partita
+    publish_pause(NULL);
+
     // creazione del socket in ascolto
     g_server.server_sockfd = socket(AF_INET, SOCK_STREAM, 0);
     if (g_server.server_sockfd < 0)
@@ -1292,14 +2498,14 @@ int server_init(
         close(g_server.server_sockfd);
         return -1;
     }
-    if (listen(g_server.server_sockfd, 8) < 0)
+    if (listen(g_server.server_sockfd, SOMAXCONN) < 0)
     {
         perror("listen");
         close(g_server.server_sockfd);
         return -1;
     }
 
-    safe_printf("[SERVER] In ascolto sulla porta %d \n", port);
+    console_printf(CONSOLE_INFO, "[SERVER] In ascolto sulla porta %d \n", port);
     log_event("[SYSTEM] Server in ascolto sulla porta %d", port);
     return 0;
 }
@@ -1311,6 +2517,7 @@ int server_init(
             - trova uno slot libero nell'array di client
             - registra il nuovo client e crea un thread dedicato
         il server rimane in attesa di connessioni finche' non viene inviato un segnale di SIGINT (CTRL+C)
+        in modalita' epoll il loop di accept e i thread per client sono sostituiti da reactor_run
 
     si assume che:
         - il server sia stato inizializzato correttamente
@@ -1325,6 +2532,14 @@ int server_run()
     sigaction(SIGINT, &sa, NULL);
     log_event("[SYSTEM] Gestore SIGINT impostato");
 
+    // SIGUSR1/SIGUSR2 cambiano la verbosita' della console; SA_RESTART: le system call
+    // bloccanti interrotte (read, accept) ripartono da sole
+    sa.sa_handler = verbosity_handler;
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &sa, NULL);
+    sigaction(SIGUSR2, &sa, NULL);
+    log_event("[SYSTEM] Verbosita' della console: %s (SIGUSR1/SIGUSR2 per cambiarla)", console_level_name(console_level));
+
     // avvio thread orchestrator
     if (pthread_create(&g_server.orchestrator_thread_id, NULL, orchestrator_thread, NULL) != 0)
     {
@@ -1342,6 +2557,23 @@ int server_run()
 
     log_event("[SYSTEM] Thread scorer avviato");
 
+    // avvio pool di verifica parole
+    if (g_server.workers > 0)
+    {
+        if (workpool_start(g_server.workers, word_job_run) < 0)
+        {
+            fprintf(stderr, "Errore avvio worker, verifica parole nei thread di I/O\n");
+            g_server.workers = 0;
+        }
+        else
+        {
+            log_event("[SYSTEM] Avviati %d worker per la verifica delle parole", g_server.workers);
+        }
+    }
+
+    if (g_server.use_epoll)
+        return reactor_run();
+
     // loop di accept per le connessioni client
     while (!g_server.stop)
     {
@@ -1358,48 +2590,24 @@ int server_run()
             continue;
         }
         log_event("[ACCEPT] Nuova connessione accettata");
-        safe_printf("[SERVER] nuovo client connesso \n");
+        console_printf(CONSOLE_INFO, "[SERVER] nuovo client connesso \n");
 
-        char welcome[256];
-        snprintf(welcome, sizeof(welcome), "Benvenuto sul server %s", g_server.server_name);
-
-        // cerca uno slot libero
-        pthread_mutex_lock(&g_server.clients_mutex);
-        int idx = -1;
-        for (int i = 0; i < MAX_CLIENTS; i++)
-        {
-            if (!g_server.clients[i].connected)
-            {
-                idx = i;
-                break;
-            }
-        }
+        int idx = client_slot_open(newsock);
         if (idx < 0)
-        {
-            pthread_mutex_unlock(&g_server.clients_mutex);
-            send_message(newsock, MSG_ERR, "Server pieno", strlen("Server pieno") + 1);
-            close(newsock);
-            log_event("[ACCEPT] Connessione rifiutata: server pieno");
             continue;
-        }
-        g_server.clients[idx].sockfd = newsock;
-        g_server.clients[idx].connected = true;
-        g_server.clients[idx].score = 0;
-        g_server.clients[idx].used_words_count = 0;
-        g_server.clients[idx].username[0] = '\0';
-        pthread_mutex_unlock(&g_server.clients_mutex);
 
         // creazione thread per gestire il nuovo client
         int *arg = malloc(sizeof(int));
         *arg = idx;
-        if (pthread_create(&g_server.clients[idx].thread_id, NULL, client_thread, arg) != 0)
+        pthread_mutex_lock(&g_server.clients_mutex);
+        g_server.client_threads++;
+        pthread_mutex_unlock(&g_server.clients_mutex);
+        if (pthread_create(&g_server.clients[idx]->thread_id, NULL, client_thread, arg) != 0)
         {
             perror("pthread_create client");
             free(arg);
-            pthread_mutex_lock(&g_server.clients_mutex);
-            g_server.clients[idx].connected = false;
-            pthread_mutex_unlock(&g_server.clients_mutex);
-            close(newsock);
+            client_disconnect(idx);
+            client_thread_done();
             log_event("[ACCEPT] Errore creazione thread per client in slot %d", idx);
         }
         else
@@ -1408,7 +2616,7 @@ int server_run()
         }
     }
 
-    safe_printf("[SERVER] Uscita dal loop di accept \n");
+    console_printf(CONSOLE_INFO, "[SERVER] Uscita dal loop di accept \n");
     log_event("[SYSTEM] Server: uscita dal loop di accept");
     return 0;
 }
@@ -1419,12 +2627,14 @@ int server_run()
             + imposta stop flag
             + invia MSG_SERVER_SHUTDWON a tutti client
             + chiude il socket in ascolto
+            + attende la fine dei thread dei client
             + attende la termionazione del thread orch.
             + libera risorse
 
     si assume che:
         - il server sia stato inizializzato correttamente, e sia in esecuzione
         - tutte le risorse siano state allocate correttamente
+        - venga chiamata dal main, all'uscita dal loop di accept o dal reactor
 */
 void server_shutdown()
 {
@@ -1437,11 +2647,15 @@ void server_shutdown()
     shutdown_in_progress = true;
 
     g_server.stop = true;
-    safe_printf("\n[SERVER] avvio shutdown... \n");
+    console_printf(CONSOLE_INFO, "\n[SERVER] avvio shutdown... \n");
     log_event("[SYSTEM] Avvio shutdown");
 
+    // Risveglia l'orchestrator in attesa della fine della fase
+    uint64_t one = 1;
+    if (write(g_server.stop_event_fd, &one, sizeof(one)) < 0)
+        log_event("[SYSTEM] Scrittura eventfd di stop fallita: %s", strerror(errno));
+
     // Risveglia tutti i thread bloccati sui condition variable:
-    pthread_cond_broadcast(&score_queue_cond);
     pthread_cond_broadcast(&ranking_cond);
 
     // invio shutdown a tutti i client
@@ -1451,28 +2665,21 @@ void server_shutdown()
     close(g_server.server_sockfd);
     log_event("[SYSTEM] Socket in ascolto chiuso");
 
-    // libera il dizionario
-    if (g_server.dictionary)
-    {
-        trie_free((trie_node *)g_server.dictionary);
-        g_server.dictionary = NULL;
-    }
-
-    // cancel e join per evitare creazione thread zombie
+    // attesa dei thread dei client: con il socket chiuso da broadcast_server_shutdown la read
+    // fallisce e il thread esce da client_disconnect. va fatta prima di fermare i worker e di
+    // liberare dizionario, record dei client e mutex che i thread usano fino all'uscita
     pthread_mutex_lock(&g_server.clients_mutex);
-    for (int i = 0; i < MAX_CLIENTS; i++)
-    {
-        if (g_server.clients[i].connected)
-        {
+    while (g_server.client_threads > 0)
+        pthread_cond_wait(&g_server.client_threads_cond, &g_server.clients_mutex);
+    pthread_mutex_unlock(&g_server.clients_mutex);
+    log_event("[SYSTEM] Thread dei client terminati");
 
-            // forza l'uscita (cancel)
-            pthread_cancel(g_server.clients[i].thread_id);
-            // attesa  terminazione effettiva (join)
-            pthread_join(g_server.clients[i].thread_id, NULL);
-            log_event("[SYSTEM] Thread client in slot %d terminato", i);
-        }
+    // i worker usano matrice e dizionario: vanno fermati prima di liberarli
+    if (g_server.workers > 0)
+    {
+        workpool_stop();
+        log_event("[SYSTEM] Worker terminati");
     }
-    pthread_mutex_unlock(&g_server.clients_mutex);
 
     pthread_cancel(g_server.scorer_thread_id);
     pthread_join(g_server.scorer_thread_id, NULL);
@@ -1482,24 +2689,60 @@ void server_shutdown()
     pthread_join(g_server.orchestrator_thread_id, NULL);
     log_event("[SYSTEM] Thread orchestrator terminato");
 
-    safe_printf("[SERVER] Shutdown completato.\n");
+    // libera il dizionario: solo ora, l'orchestrator lo usa per risolvere la matrice a ogni partita
+    if (g_server.dictionary)
+    {
+        trie_free((trie_node *)g_server.dictionary);
+        g_server.dictionary = NULL;
+    }
+
+    // il gestore di SIGUSR1/SIGUSR2 scrive verbosity_event_fd: va rimosso prima di chiuderlo
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGUSR1, &sa, NULL);
+    sigaction(SIGUSR2, &sa, NULL);
+
+    close(g_server.phase_timer_fd);
+    close(g_server.stop_event_fd);
+    close(g_server.live_timer_fd);
+    close(g_server.verbosity_event_fd);
+
+    // nessun lettore ne' pubblicatore attivo: libera gli snapshot e le parole valide
+    snapshot_shutdown();
+
+    console_printf(CONSOLE_INFO, "[SERVER] Shutdown completato.\n");
     log_event("[SYSTEM] Shutdown completato");
 
     // distrugge i mutex e i condition variables
     pthread_mutex_destroy(&g_server.clients_mutex);
-    pthread_mutex_destroy(&g_server.log_mutex);
+    pthread_cond_destroy(&g_server.client_threads_cond);
+    // compatta e chiude il journal degli utenti
+    userstore_close();
     pthread_mutex_destroy(&g_server.registered_mutex);
-    pthread_mutex_destroy(&score_queue_mutex);
+    for (int i = 0; i < SESSION_STRIPES; i++)
+        pthread_mutex_destroy(&g_server.session_locks[i]);
+    free(g_server.sessions);
+    g_server.sessions = NULL;
+    for (int i = 0; i < g_server.client_slots; i++)
+    {
+        pthread_mutex_destroy(&g_server.clients[i]->out_mutex);
+        pthread_mutex_destroy(&g_server.clients[i]->state_mutex);
+        free(g_server.clients[i]->out_buf);
+        free(g_server.clients[i]->used_words);
+        msg_reader_free(&g_server.clients[i]->reader);
+        free(g_server.clients[i]);
+    }
+    free(g_server.clients);
+    g_server.clients = NULL;
+    g_server.client_slots = 0;
+    leaderboard_shutdown();
     pthread_mutex_destroy(&bacheca_mutex);
     pthread_mutex_destroy(&ranking_mutex);
-    pthread_cond_destroy(&score_queue_cond);
     pthread_cond_destroy(&ranking_cond);
 
-    if (g_server.log_fp)
-    {
-        fclose(g_server.log_fp);
-        g_server.log_fp = NULL;
-    }
+    // scrive i messaggi ancora in coda e chiude il file
+    asynclog_close();
 
     if (g_server.matrix_fp)
         fclose(g_server.matrix_fp);
@@ -1520,4 +2763,15 @@ void server_set_name(const char *name)
     strncpy(g_server.server_name, name, sizeof(g_server.server_name) - 1);
     g_server.server_name[sizeof(g_server.server_name) - 1] = '\0';
     log_event("[SYSTEM] Nome server impostato a: %s", g_server.server_name);
+}
+
+/*
+   server_set_verbosity:
+   Imposta il livello di verbosita' iniziale della console (CONSOLE_*).
+   si assume che:
+   - CONSOLE_OFF <= level <= CONSOLE_DEBUG
+*/
+void server_set_verbosity(int level)
+{
+    __atomic_store_n(&console_level, level, __ATOMIC_RELAXED);
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#define _GNU_SOURCE
+
+#include "snapshot.h"
+#include "solver.h"
+#include "frame.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+// ======================= lettori =======================
+
+// record di un thread lettore: allocati una volta e mai liberati, riusati quando il thread termina
+typedef struct reader
+{
+    uint64_t epoch; // epoca di ingresso nella sezione di lettura, 0 = fuori sezione
+    bool in_use;
+    struct reader *next;
+} reader;
+
+static reader *g_readers;          // lista dei record (solo inserimenti in testa)
+static pthread_mutex_t readers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t reader_key;
+static pthread_once_t reader_once = PTHREAD_ONCE_INIT;
+
+static uint64_t g_epoch = 1;
+static game_snapshot *g_current;
+static game_snapshot *g_retired; // snapshot sostituiti non ancora liberati (solo orchestrator)
+
+// alla terminazione del thread il record torna disponibile
+static void reader_release(void *arg)
+{
+    reader *r = arg;
+    __atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+    pthread_mutex_lock(&readers_mutex);
+    r->in_use = false;
+    pthread_mutex_unlock(&readers_mutex);
+}
+
+static void reader_key_init()
+{
+    pthread_key_create(&reader_key, reader_release);
+}
+
+// record del thread chiamante, assegnato al primo utilizzo
+static reader *reader_self()
+{
+    pthread_once(&reader_once, reader_key_init);
+    reader *r = pthread_getspecific(reader_key);
+    if (r)
+        return r;
+
+    pthread_mutex_lock(&readers_mutex);
+    for (r = g_readers; r; r = r->next)
+    {
+        if (!r->in_use)
+            break;
+    }
+    if (!r)
+    {
+        r = calloc(1, sizeof(reader));
+        if (!r)
+        {
+            pthread_mutex_unlock(&readers_mutex);
+            perror("calloc reader");
+            exit(EXIT_FAILURE);
+        }
+        r->next = g_readers;
+        __atomic_store_n(&g_readers, r, __ATOMIC_RELEASE);
+    }
+    r->in_use = true;
+    pthread_mutex_unlock(&readers_mutex);
+
+    pthread_setspecific(reader_key, r);
+    return r;
+}
+
+// epoca minima tra i lettori attivi, UINT64_MAX se nessuno e' in sezione
+static uint64_t min_active_epoch()
+{
+    uint64_t min = UINT64_MAX;
+    for (reader *r = __atomic_load_n(&g_readers, __ATOMIC_ACQUIRE); r; r = r->next)
+    {
+        uint64_t e = __atomic_load_n(&r->epoch, __ATOMIC_SEQ_CST);
+        if (e != 0 && e < min)
+            min = e;
+    }
+    return min;
+}
+
+const game_snapshot *snapshot_enter()
+{
+    reader *r = reader_self();
+    // l'annuncio dell'epoca deve essere visibile prima di leggere il puntatore (SEQ_CST)
+    __atomic_store_n(&r->epoch, __atomic_load_n(&g_epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&g_current, __ATOMIC_SEQ_CST);
+}
+
+void snapshot_exit()
+{
+    reader *r = pthread_getspecific(reader_key);
+    __atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+}
+
+// ======================= pubblicazione e recupero =======================
+
+static void snapshot_free(game_snapshot *snap)
+{
+    solved_board_free(snap->solved);
+    frame_unref(snap->matrix_frame);
+    free(snap);
+}
+
+/*
+    reclaim:
+        libera gli snapshot ritirati prima dell'ingresso del lettore attivo piu' vecchio:
+        un lettore entrato all'epoca e puo' aver letto solo snapshot ritirati a epoche >= e
+*/
+static void reclaim()
+{
+    uint64_t min = min_active_epoch();
+    game_snapshot **link = &g_retired;
+    while (*link)
+    {
+        game_snapshot *snap = *link;
+        if (snap->retired_epoch < min)
+        {
+            *link = snap->retired_next;
+            snapshot_free(snap);
+        }
+        else
+        {
+            link = &snap->retired_next;
+        }
+    }
+}
+
+void snapshot_render_matrix(game_snapshot *snap)
+{
+    size_t offset = 0;
+    size_t size = sizeof(snap->matrix_str);
+    int cells = snap->dim * snap->dim;
+    snap->matrix_str[0] = '\0';
+    for (int i = 0; i < cells && offset < size; i++)
+    {
+        offset += snprintf(snap->matrix_str + offset, size - offset, i < cells - 1 ? "%s " : "%s", snap->matrix[i]);
+    }
+}
+
+void snapshot_publish(game_snapshot *snap)
+{
+    game_snapshot *old = __atomic_exchange_n(&g_current, snap, __ATOMIC_SEQ_CST);
+    if (old)
+    {
+        old->retired_epoch = __atomic_load_n(&g_epoch, __ATOMIC_SEQ_CST);
+        old->retired_next = g_retired;
+        g_retired = old;
+    }
+    // i lettori che entrano da qui in poi non possono vedere 'old'
+    __atomic_add_fetch(&g_epoch, 1, __ATOMIC_SEQ_CST);
+    reclaim();
+}
+
+void snapshot_synchronize()
+{
+    uint64_t target = __atomic_fetch_add(&g_epoch, 1, __ATOMIC_SEQ_CST);
+    while (min_active_epoch() <= target)
+    {
+        struct timespec req = {0, 1000 * 1000}; // 1 ms
+        nanosleep(&req, NULL);
+    }
+    reclaim();
+}
+
+void snapshot_shutdown()
+{
+    reclaim();
+    while (g_retired)
+    {
+        game_snapshot *snap = g_retired;
+        g_retired = snap->retired_next;
+        snapshot_free(snap);
+    }
+    if (g_current)
+    {
+        snapshot_free(g_current);
+        g_current = NULL;
+    }
+}
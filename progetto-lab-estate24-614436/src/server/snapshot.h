@@ -0,0 +1,102 @@
+/*
+snapshot.h
+    stato di gioco immutabile pubblicato dall'orchestrator (stile RCU)
+
+    a ogni cambio di fase (inizio partita, fine partita, inizio pausa) l'orchestrator
+    costruisce un nuovo snapshot completo - matrice, stringa della matrice gia' pronta
+    per il protocollo, tempi della fase, insieme delle parole valide - e lo pubblica
+    con uno scambio atomico del puntatore corrente. uno snapshot pubblicato non viene
+    piu' modificato: i lettori non prendono lock e non possono vedere una matrice a meta'.
+
+    la memoria degli snapshot sostituiti viene recuperata con epoch-based reclamation:
+    ogni thread lettore annuncia l'epoca in cui e' entrato nella sezione di lettura,
+    uno snapshot ritirato all'epoca E viene liberato solo quando nessun lettore attivo
+    e' entrato a un'epoca <= E.
+*/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "matrix.h"
+
+#define SNAPSHOT_MATRIX_STR_LEN (BOARD_MAX_CELLS * 5) // celle (al piu' "Qu") separate da spazio
+
+struct solved_board;
+struct frame;
+
+typedef struct game_snapshot
+{
+    uint64_t round; // numero della partita (0 prima della prima partita)
+    bool running;   // true durante la partita, false in pausa
+
+    int dim;
+    char matrix[BOARD_MAX_CELLS][5];
+    char matrix_str[SNAPSHOT_MATRIX_STR_LEN]; // celle separate da spazio, formato di MSG_MATRICE
+    encoded_board board;
+
+    time_t start_time; // inizio della fase (partita o pausa)
+    time_t end_time;   // fine prevista della fase
+
+    // parole valide della matrice (solo durante la partita, NULL in pausa), di proprieta' dello snapshot
+    struct solved_board *solved;
+    int solved_count;
+    int solved_max_score;
+
+    // messaggio MSG_MATRICE gia' serializzato (solo durante la partita, NULL in pausa),
+    // lo snapshot ne possiede un riferimento
+    struct frame *matrix_frame;
+
+    // recupero della memoria (usati solo dall'orchestrator)
+    struct game_snapshot *retired_next;
+    uint64_t retired_epoch;
+} game_snapshot;
+
+/*
+    snapshot_render_matrix:
+        riempie matrix_str a partire da matrix e dim (celle riga per riga separate da uno spazio)
+*/
+void snapshot_render_matrix(game_snapshot *snap);
+
+/*
+    snapshot_publish:
+        rende 'snap' lo snapshot corrente e ritira il precedente, liberando gli snapshot
+        ritirati che nessun lettore puo' piu' vedere.
+    si assume che:
+        - venga chiamata da un solo thread (l'orchestrator, o l'inizializzazione prima del suo avvio)
+        - 'snap' sia allocato con malloc/calloc e completamente inizializzato
+*/
+void snapshot_publish(game_snapshot *snap);
+
+/*
+    snapshot_enter / snapshot_exit:
+        delimitano una sezione di lettura: il puntatore restituito da snapshot_enter resta valido
+        fino alla snapshot_exit corrispondente. le sezioni non possono essere annidate
+        e devono essere brevi (bloccano il recupero della memoria).
+    si assume che:
+        - sia stato pubblicato almeno uno snapshot
+*/
+const game_snapshot *snapshot_enter();
+void snapshot_exit();
+
+/*
+    snapshot_synchronize:
+        attende che tutti i lettori entrati prima della chiamata siano usciti: al ritorno
+        nessuno sta piu' usando uno snapshot sostituito prima della chiamata.
+    si assume che:
+        - venga chiamata dal thread che pubblica (non da un lettore in sezione)
+*/
+void snapshot_synchronize();
+
+/*
+    snapshot_shutdown:
+        libera lo snapshot corrente e tutti quelli ritirati.
+    si assume che:
+        - non ci siano piu' lettori attivi
+*/
+void snapshot_shutdown();
+
+#endif // SNAPSHOT_H
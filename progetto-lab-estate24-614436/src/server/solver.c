@@ -0,0 +1,215 @@
+#include "solver.h"
+
+#define MAX_WORD_CHARS (BOARD_MAX_CELLS * 2 + 1) // ogni cella al piu' "qu", 2 caratteri
+
+// ======================= insieme delle parole =======================
+
+// FNV-1a sulla parola gia' normalizzata
+static uint32_t word_hash(const char *word)
+{
+    uint32_t h = 2166136261u;
+    for (; *word; word++)
+    {
+        h ^= (unsigned char)*word;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static bool table_grow(solved_board *sb)
+{
+    uint32_t new_capacity = sb->table_capacity ? sb->table_capacity * 2 : 256;
+    uint32_t *tmp = calloc(new_capacity, sizeof(uint32_t));
+    if (!tmp)
+        return false;
+    for (uint32_t i = 0; i < sb->count; i++)
+    {
+        uint32_t pos = word_hash(sb->text + sb->words[i].offset) & (new_capacity - 1);
+        while (tmp[pos])
+            pos = (pos + 1) & (new_capacity - 1);
+        tmp[pos] = i + 1;
+    }
+    free(sb->table);
+    sb->table = tmp;
+    sb->table_capacity = new_capacity;
+    return true;
+}
+
+// cerca la parola nella tabella, restituisce l'indice o -1
+static int table_find(const solved_board *sb, const char *word)
+{
+    if (sb->table_capacity == 0)
+        return -1;
+    uint32_t pos = word_hash(word) & (sb->table_capacity - 1);
+    while (sb->table[pos])
+    {
+        uint32_t id = sb->table[pos] - 1;
+        if (strcmp(sb->text + sb->words[id].offset, word) == 0)
+            return (int)id;
+        pos = (pos + 1) & (sb->table_capacity - 1);
+    }
+    return -1;
+}
+
+// aggiunge la parola se non e' gia' presente (puo' essere trovata lungo piu' cammini)
+static bool add_word(solved_board *sb, const char *word, size_t len, int score)
+{
+    if (table_find(sb, word) >= 0)
+        return true;
+
+    if ((sb->count + 1) * 2 > sb->table_capacity && !table_grow(sb))
+        return false;
+    if (sb->count == sb->capacity)
+    {
+        uint32_t new_capacity = sb->capacity ? sb->capacity * 2 : 64;
+        solved_word *tmp = realloc(sb->words, new_capacity * sizeof(solved_word));
+        if (!tmp)
+            return false;
+        sb->words = tmp;
+        sb->capacity = new_capacity;
+    }
+    if (sb->text_len + len + 1 > sb->text_capacity)
+    {
+        size_t new_capacity = sb->text_capacity ? sb->text_capacity * 2 : 1024;
+        while (new_capacity < sb->text_len + len + 1)
+            new_capacity *= 2;
+        char *tmp = realloc(sb->text, new_capacity);
+        if (!tmp)
+            return false;
+        sb->text = tmp;
+        sb->text_capacity = new_capacity;
+    }
+
+    memcpy(sb->text + sb->text_len, word, len + 1);
+    sb->words[sb->count].offset = (uint32_t)sb->text_len;
+    sb->words[sb->count].score = score;
+    sb->text_len += len + 1;
+
+    uint32_t pos = word_hash(word) & (sb->table_capacity - 1);
+    while (sb->table[pos])
+        pos = (pos + 1) & (sb->table_capacity - 1);
+    sb->table[pos] = sb->count + 1;
+    sb->count++;
+    sb->max_score += score;
+    return true;
+}
+
+// ======================= visita griglia + dizionario =======================
+
+typedef struct
+{
+    const trie_node *dict;
+    const encoded_board *board;
+    solved_board *sb;
+    char word[MAX_WORD_CHARS];
+    bool ok; // false se la memoria e' esaurita
+} solver_ctx;
+
+/*
+    solve_from:
+        estende il cammino corrente (lungo 'depth' celle, 'len' caratteri, celle usate in
+        'visited') con la cella 'cell', scendendo nel dizionario a partire da 'node'.
+        la visita si interrompe appena il cammino non e' piu' prefisso di alcuna parola.
+*/
+static void solve_from(solver_ctx *ctx, int cell, uint32_t node, int depth, size_t len, board_mask visited)
+{
+    int code = ctx->board->cells[cell];
+    if (code == BOARD_NO_LETTER)
+        return;
+    node = trie_child(ctx->dict, node, code);
+    if (node == TRIE_NO_NODE)
+        return;
+
+    if (code == 26)
+    {
+        ctx->word[len++] = 'q';
+        ctx->word[len++] = 'u';
+    }
+    else
+    {
+        ctx->word[len++] = (char)('a' + code);
+    }
+    ctx->word[len] = '\0';
+    depth++;
+
+    if (depth >= SOLVER_MIN_LETTERS && trie_is_word(ctx->dict, node))
+    {
+        if (!add_word(ctx->sb, ctx->word, len, depth))
+            ctx->ok = false;
+    }
+
+    visited |= (board_mask)1 << cell;
+    board_mask next = ctx->board->neighbors[cell] & ~visited;
+    while (next && ctx->ok)
+    {
+        int n = __builtin_ctzll(next);
+        next &= next - 1;
+        solve_from(ctx, n, node, depth, len, visited);
+    }
+}
+
+solved_board *solve_board(const encoded_board *board, const trie_node *dict)
+{
+    solved_board *sb = calloc(1, sizeof(solved_board));
+    if (!sb)
+        return NULL;
+
+    solver_ctx ctx;
+    ctx.dict = dict;
+    ctx.board = board;
+    ctx.sb = sb;
+    ctx.ok = true;
+    for (int i = 0; i < board->cell_count && ctx.ok; i++)
+        solve_from(&ctx, i, 0, 0, 0, 0);
+
+    if (!ctx.ok)
+    {
+        solved_board_free(sb);
+        return NULL;
+    }
+    return sb;
+}
+
+// ======================= ricerca =======================
+
+int solved_board_find(const solved_board *sb, const char *word, int *points)
+{
+    if (sb == NULL || word == NULL)
+        return -1;
+
+    // normalizzazione: minuscole, solo lettere (la matrice contiene solo lettere)
+    char normalized[MAX_WORD_CHARS];
+    size_t len = 0;
+    for (; *word; word++)
+    {
+        if (len + 1 >= sizeof(normalized) || !isalpha((unsigned char)*word))
+            return -1;
+        normalized[len++] = (char)tolower((unsigned char)*word);
+    }
+    normalized[len] = '\0';
+
+    int id = table_find(sb, normalized);
+    if (id >= 0 && points)
+        *points = sb->words[id].score;
+    return id;
+}
+
+int solved_board_count(const solved_board *sb)
+{
+    return sb ? (int)sb->count : 0;
+}
+
+int solved_board_max_score(const solved_board *sb)
+{
+    return sb ? sb->max_score : 0;
+}
+
+void solved_board_free(solved_board *sb)
+{
+    if (!sb)
+        return;
+    free(sb->words);
+    free(sb->text);
+    free(sb->table);
+    free(sb);
+}
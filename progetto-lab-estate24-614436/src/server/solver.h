@@ -0,0 +1,76 @@
+/*
+solver.h
+    risoluzione completa della matrice di gioco
+
+    all'inizio di ogni partita la griglia viene visitata insieme al dizionario
+    (trie o DAWG): un cammino viene esteso solo finche' e' prefisso di qualche
+    parola, quindi la visita tocca una frazione minima dei cammini possibili.
+    il risultato e' l'insieme di tutte le parole valide (>= 4 lettere logiche,
+    presenti nel dizionario e componibili sulla griglia) con il relativo
+    punteggio, indicizzato da una tabella hash: la verifica di una parola
+    proposta diventa una singola ricerca.
+*/
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dictionary.h"
+#include "matrix.h"
+
+#define SOLVER_MIN_LETTERS 4 // lunghezza minima (in lettere logiche) di una parola valida
+
+typedef struct
+{
+    uint32_t offset; // posizione della parola (minuscola, "qu" esteso) in text[]
+    int score;       // lettere logiche, "qu" conta 1
+} solved_word;
+
+typedef struct solved_board
+{
+    solved_word *words;
+    uint32_t count;
+    uint32_t capacity;
+
+    char *text; // parole terminate da '\0' una dopo l'altra
+    size_t text_len;
+    size_t text_capacity;
+
+    uint32_t *table; // indirizzamento aperto: indice parola + 1, 0 = vuoto
+    uint32_t table_capacity;
+
+    int max_score; // somma dei punteggi di tutte le parole trovate
+} solved_board;
+
+/*
+    solve_board:
+        Calcola tutte le parole valide della matrice.
+        Si assume che 'board' sia stata prodotta da encode_board e che 'dict' sia valido.
+        Restituisce NULL se la memoria e' esaurita.
+*/
+solved_board *solve_board(const encoded_board *board, const trie_node *dict);
+
+/*
+    solved_board_find:
+        Cerca una parola (case-insensitive) tra quelle valide per la matrice.
+        Restituisce l'indice della parola (0..count-1) e ne scrive il punteggio in
+        'points' (se non NULL), oppure -1 se la parola non e' valida.
+*/
+int solved_board_find(const solved_board *sb, const char *word, int *points);
+
+/*
+    solved_board_count / solved_board_max_score:
+        numero di parole valide e punteggio massimo ottenibile sulla matrice.
+*/
+int solved_board_count(const solved_board *sb);
+int solved_board_max_score(const solved_board *sb);
+
+/*
+    solved_board_free:
+        Libera l'insieme delle parole. Si assume che 'sb' sia valido o NULL.
+*/
+void solved_board_free(solved_board *sb);
+
+#endif // SOLVER_H
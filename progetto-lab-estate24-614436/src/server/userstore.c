@@ -0,0 +1,255 @@
+#define _GNU_SOURCE
+
+#include "userstore.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// ======================= tabella hash =======================
+
+typedef struct
+{
+    char username[USERSTORE_NAME_LEN]; // "" = cella libera
+    user_state state;
+} user_entry;
+
+static struct
+{
+    user_entry *table;
+    uint32_t capacity; // potenza di 2
+    uint32_t count;    // utenti nella tabella (anche cancellati)
+    int active;        // utenti non cancellati
+
+    char *path;        // journal, NULL se l'archivio non e' persistente
+    FILE *journal;
+    long journal_lines;
+} g_users;
+
+// FNV-1a sul nome utente
+static uint32_t name_hash(const char *name)
+{
+    uint32_t h = 2166136261u;
+    for (; *name; name++)
+    {
+        h ^= (unsigned char)*name;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// cella del nome se presente, altrimenti la cella libera dove inserirlo
+static user_entry *table_slot(user_entry *table, uint32_t capacity, const char *name)
+{
+    uint32_t pos = name_hash(name) & (capacity - 1);
+    while (table[pos].username[0] != '\0' && strcmp(table[pos].username, name) != 0)
+        pos = (pos + 1) & (capacity - 1);
+    return &table[pos];
+}
+
+static bool table_grow()
+{
+    uint32_t new_capacity = g_users.capacity ? g_users.capacity * 2 : 1024;
+    user_entry *tmp = calloc(new_capacity, sizeof(user_entry));
+    if (!tmp)
+        return false;
+    for (uint32_t i = 0; i < g_users.capacity; i++)
+    {
+        if (g_users.table[i].username[0] != '\0')
+            *table_slot(tmp, new_capacity, g_users.table[i].username) = g_users.table[i];
+    }
+    free(g_users.table);
+    g_users.table = tmp;
+    g_users.capacity = new_capacity;
+    return true;
+}
+
+// imposta lo stato dell'utente, inserendolo se assente
+static int table_set(const char *name, user_state state)
+{
+    // fattore di carico massimo 0.7
+    if ((g_users.count + 1) * 10 > g_users.capacity * 7 && !table_grow())
+        return -1;
+
+    user_entry *e = table_slot(g_users.table, g_users.capacity, name);
+    if (e->username[0] == '\0')
+    {
+        strncpy(e->username, name, USERSTORE_NAME_LEN - 1);
+        e->username[USERSTORE_NAME_LEN - 1] = '\0';
+        e->state = USER_ASSENTE;
+        g_users.count++;
+    }
+    if (e->state == USER_ATTIVO)
+        g_users.active--;
+    if (state == USER_ATTIVO)
+        g_users.active++;
+    e->state = state;
+    return 0;
+}
+
+// ======================= journal =======================
+
+/*
+    journal_reopen:
+        riapre il journal in append dopo una compattazione. se non ci riesce lo segnala e lascia
+        journal a NULL: il file compattato contiene gia' tutti gli utenti e la riapertura viene
+        ritentata al prossimo aggiornamento. restituisce false se il journal resta chiuso
+*/
+static bool journal_reopen()
+{
+    g_users.journal = fopen(g_users.path, "a");
+    if (!g_users.journal)
+    {
+        perror("fopen journal utenti");
+        return false;
+    }
+    return true;
+}
+
+static void journal_append(char op, const char *name)
+{
+    // archivio non persistente, oppure journal non riapribile dopo una compattazione
+    if (!g_users.journal && (!g_users.path || !journal_reopen()))
+        return;
+    fprintf(g_users.journal, "%c%s\n", op, name);
+    fflush(g_users.journal);
+    g_users.journal_lines++;
+}
+
+/*
+    journal_compact:
+        riscrive il journal con una riga per utente (stato finale) e lo riapre in append.
+        in caso di errore il journal corrente resta valido
+*/
+static void journal_compact()
+{
+    if (!g_users.path)
+        return;
+
+    char *tmp_path;
+    if (asprintf(&tmp_path, "%s.tmp", g_users.path) < 0)
+        return;
+    FILE *fp = fopen(tmp_path, "w");
+    if (!fp)
+    {
+        free(tmp_path);
+        return;
+    }
+    long lines = 0;
+    for (uint32_t i = 0; i < g_users.capacity; i++)
+    {
+        const user_entry *e = &g_users.table[i];
+        if (e->username[0] == '\0')
+            continue;
+        fprintf(fp, "%c%s\n", e->state == USER_ATTIVO ? '+' : '-', e->username);
+        lines++;
+    }
+    if (fclose(fp) != 0 || rename(tmp_path, g_users.path) != 0)
+    {
+        remove(tmp_path);
+        free(tmp_path);
+        return;
+    }
+    free(tmp_path);
+
+    if (g_users.journal)
+        fclose(g_users.journal);
+    g_users.journal_lines = lines;
+    journal_reopen();
+}
+
+static void journal_maybe_compact()
+{
+    if (g_users.journal_lines > 2L * g_users.count + USERSTORE_COMPACT_SLACK)
+        journal_compact();
+}
+
+// rilegge il journal: le righe successive prevalgono sulle precedenti
+static int journal_load(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return 0; // primo avvio, nessun utente
+
+    char line[USERSTORE_NAME_LEN + 2];
+    while (fgets(line, sizeof(line), fp))
+    {
+        line[strcspn(line, "\n")] = '\0';
+        g_users.journal_lines++;
+        if ((line[0] != '+' && line[0] != '-') || line[1] == '\0')
+            continue; // riga non valida (ad esempio troncata da un arresto)
+        if (table_set(line + 1, line[0] == '+' ? USER_ATTIVO : USER_CANCELLATO) < 0)
+        {
+            fclose(fp);
+            return -1;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+// ======================= API =======================
+
+int userstore_open(const char *path)
+{
+    memset(&g_users, 0, sizeof(g_users));
+    if (!table_grow())
+        return -1;
+    if (!path)
+        return 0;
+
+    // in caso di errore path torna NULL: userstore_close non deve compattare una tabella incompleta
+    g_users.path = strdup(path);
+    if (!g_users.path || journal_load(path) < 0 || !(g_users.journal = fopen(path, "a")))
+    {
+        free(g_users.path);
+        g_users.path = NULL;
+        return -1;
+    }
+    journal_maybe_compact();
+    return 0;
+}
+
+user_state userstore_lookup(const char *username)
+{
+    return table_slot(g_users.table, g_users.capacity, username)->state;
+}
+
+int userstore_register(const char *username)
+{
+    if (table_set(username, USER_ATTIVO) < 0)
+        return -1;
+    journal_append('+', username);
+    journal_maybe_compact();
+    return 0;
+}
+
+bool userstore_delete(const char *username)
+{
+    user_entry *e = table_slot(g_users.table, g_users.capacity, username);
+    if (e->state != USER_ATTIVO)
+        return false;
+    e->state = USER_CANCELLATO;
+    g_users.active--;
+    journal_append('-', username);
+    journal_maybe_compact();
+    return true;
+}
+
+int userstore_active_count()
+{
+    return g_users.active;
+}
+
+void userstore_close()
+{
+    // compatta anche se il journal non e' aperto (riapertura fallita): salva lo stato finale
+    if (g_users.path)
+        journal_compact();
+    if (g_users.journal)
+        fclose(g_users.journal);
+    free(g_users.path);
+    free(g_users.table);
+    memset(&g_users, 0, sizeof(g_users));
+}
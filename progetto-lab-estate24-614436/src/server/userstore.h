@@ -0,0 +1,78 @@
+/*
+userstore.h
+    archivio degli utenti registrati
+
+    gli utenti sono indicizzati in una tabella hash a indirizzamento aperto
+    (sondaggio lineare) che raddoppia quando supera il 70% di occupazione:
+    ricerca, inserimento e cancellazione logica in tempo costante medio, senza
+    limite fisso al numero di utenti. un utente cancellato resta nella tabella
+    marcato come tale (la registrazione successiva lo riattiva).
+
+    ogni modifica viene aggiunta in coda a un journal testuale, una riga per operazione:
+        +nome   registrazione o riattivazione
+        -nome   cancellazione
+    all'avvio il journal viene riletto per ricostruire la tabella. quando le righe
+    superano il doppio degli utenti (piu' una soglia fissa) il journal viene compattato:
+    riscritto con una sola riga per utente in un file temporaneo, poi sostituito con rename.
+
+    le funzioni non sono thread-safe: il server le chiama sotto registered_mutex.
+*/
+
+#ifndef USERSTORE_H
+#define USERSTORE_H
+
+#include <stdbool.h>
+
+#define DEFAULT_USERS_FILE "paroliere_utenti.journal"
+#define USERSTORE_NAME_LEN 32        // nome utente compreso il terminatore
+#define USERSTORE_COMPACT_SLACK 1024 // righe di journal tollerate oltre il doppio degli utenti
+
+typedef enum
+{
+    USER_ASSENTE,   // mai registrato
+    USER_ATTIVO,    // registrato
+    USER_CANCELLATO // registrato e poi cancellato
+} user_state;
+
+/*
+    userstore_open:
+        crea l'archivio e, se path non e' NULL, carica il journal (se esiste) e lo apre in append.
+        restituisce 0 in caso di successo, -1 se la memoria e' esaurita o il journal non e' apribile
+*/
+int userstore_open(const char *path);
+
+/*
+    userstore_lookup:
+        restituisce lo stato dell'utente 'username'
+*/
+user_state userstore_lookup(const char *username);
+
+/*
+    userstore_register:
+        registra l'utente (o lo riattiva se cancellato) e aggiunge l'operazione al journal.
+        restituisce 0 in caso di successo, -1 se la memoria e' esaurita
+    si assume che:
+        - username sia un nome valido (al piu' USERSTORE_NAME_LEN - 1 caratteri, senza a capo)
+*/
+int userstore_register(const char *username);
+
+/*
+    userstore_delete:
+        cancella logicamente l'utente e aggiunge l'operazione al journal.
+        restituisce false se l'utente non e' registrato o e' gia' cancellato
+*/
+bool userstore_delete(const char *username);
+
+/*
+    userstore_active_count:
+        numero di utenti registrati e non cancellati
+*/
+int userstore_active_count();
+
+/*
+    userstore_close:
+        compatta il journal, lo chiude e libera la tabella
+*/
+void userstore_close();
+
+#endif // USERSTORE_H
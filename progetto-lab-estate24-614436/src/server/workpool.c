@@ -0,0 +1,111 @@
+#define _GNU_SOURCE
+
+#include "workpool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// ======================= stato del pool =======================
+
+static struct
+{
+    word_job jobs[WORK_QUEUE_CAPACITY]; // coda circolare
+    int head;                           // prossimo job da estrarre
+    int count;                          // job in coda
+
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+
+    pthread_t *threads;
+    int thread_count;
+    word_job_fn fn;
+    bool running;
+} g_pool = {.mutex = PTHREAD_MUTEX_INITIALIZER, .not_empty = PTHREAD_COND_INITIALIZER};
+
+// ======================= worker =======================
+/*
+    worker_thread:
+        estrae un job alla volta e lo esegue fuori dal mutex della coda,
+        cosi' piu' worker verificano parole in parallelo
+*/
+static void *worker_thread(void *arg)
+{
+    (void)arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&g_pool.mutex);
+        while (g_pool.count == 0 && g_pool.running)
+            pthread_cond_wait(&g_pool.not_empty, &g_pool.mutex);
+        if (!g_pool.running)
+        {
+            pthread_mutex_unlock(&g_pool.mutex);
+            return NULL;
+        }
+        word_job job = g_pool.jobs[g_pool.head];
+        g_pool.head = (g_pool.head + 1) % WORK_QUEUE_CAPACITY;
+        g_pool.count--;
+        pthread_mutex_unlock(&g_pool.mutex);
+
+        g_pool.fn(&job);
+    }
+}
+
+// ======================= API =======================
+
+int workpool_start(int workers, word_job_fn fn)
+{
+    g_pool.threads = calloc(workers, sizeof(pthread_t));
+    if (!g_pool.threads)
+        return -1;
+
+    g_pool.fn = fn;
+    g_pool.head = 0;
+    g_pool.count = 0;
+    g_pool.running = true;
+    for (int i = 0; i < workers; i++)
+    {
+        if (pthread_create(&g_pool.threads[i], NULL, worker_thread, NULL) != 0)
+        {
+            perror("pthread_create worker");
+            workpool_stop();
+            return -1;
+        }
+        g_pool.thread_count++;
+    }
+    return 0;
+}
+
+bool workpool_try_submit(const word_job *job)
+{
+    pthread_mutex_lock(&g_pool.mutex);
+    if (!g_pool.running || g_pool.count == WORK_QUEUE_CAPACITY)
+    {
+        pthread_mutex_unlock(&g_pool.mutex);
+        return false;
+    }
+    g_pool.jobs[(g_pool.head + g_pool.count) % WORK_QUEUE_CAPACITY] = *job;
+    g_pool.count++;
+    pthread_cond_signal(&g_pool.not_empty);
+    pthread_mutex_unlock(&g_pool.mutex);
+    return true;
+}
+
+void workpool_stop()
+{
+    pthread_mutex_lock(&g_pool.mutex);
+    g_pool.running = false;
+    for (int i = 0; i < g_pool.count; i++)
+        free(g_pool.jobs[(g_pool.head + i) % WORK_QUEUE_CAPACITY].words);
+    g_pool.count = 0;
+    pthread_cond_broadcast(&g_pool.not_empty);
+    pthread_mutex_unlock(&g_pool.mutex);
+
+    for (int i = 0; i < g_pool.thread_count; i++)
+        pthread_join(g_pool.threads[i], NULL);
+
+    free(g_pool.threads);
+    g_pool.threads = NULL;
+    g_pool.thread_count = 0;
+}
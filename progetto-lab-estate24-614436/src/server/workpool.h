@@ -0,0 +1,57 @@
+/*
+workpool.h
+    pool di thread worker per la verifica delle parole
+
+    i thread di I/O (un thread per client oppure il reactor epoll) non verificano
+    le parole direttamente: accodano un job in una coda circolare limitata,
+    condivisa da tutti i worker (piu' produttori, piu' consumatori).
+    i worker estraggono i job ed eseguono la funzione di verifica, che risponde
+    al client tramite il suo buffer/socket. il numero di worker (tipicamente il
+    numero di core), e non il numero di connessioni, limita la CPU usata per la
+    verifica; un picco di parole a inizio partita viene distribuito sui core.
+*/
+
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <stdbool.h>
+
+#define WORK_QUEUE_CAPACITY 1024 // job in attesa oltre i quali il produttore verifica da se'
+#define WORK_WORD_LEN 64         // lunghezza massima di una parola in un job (oltre non e' mai valida)
+
+typedef struct
+{
+    int client_idx;          // slot del client che ha proposto la parola
+    unsigned int conn_id;    // connessione a cui appartiene lo slot al momento dell'invio
+    char word[WORK_WORD_LEN];
+    char *words;             // MSG_PAROLE: parole separate da spazi (malloc, liberate dal worker), NULL per una parola
+} word_job;
+
+typedef void (*word_job_fn)(const word_job *job);
+
+/*
+    workpool_start:
+        avvia 'workers' thread che eseguono 'fn' sui job accodati.
+        restituisce 0 in caso di successo, -1 se la creazione dei thread fallisce
+        (i thread eventualmente gia' avviati vengono terminati).
+    si assume che:
+        - workers > 0 e il pool non sia gia' avviato
+*/
+int workpool_start(int workers, word_job_fn fn);
+
+/*
+    workpool_try_submit:
+        accoda una copia del job senza bloccare.
+        restituisce false se la coda e' piena o il pool non e' attivo:
+        in quel caso il chiamante esegue la verifica direttamente.
+*/
+bool workpool_try_submit(const word_job *job);
+
+/*
+    workpool_stop:
+        termina i worker (i job ancora in coda vengono scartati, liberandone le parole) e ne attende l'uscita.
+        non fa nulla se il pool non e' attivo.
+*/
+void workpool_stop();
+
+#endif // WORKPOOL_H
@@ -0,0 +1,215 @@
+/*
+logdump.c
+
+decodifica offline del log binario degli eventi del server (server/eventlog.h)
+
+sintassi:
+ *   ./paroliere_logdump [--csv] file_eventi...
+ *
+ *  Opzioni:
+     - --csv: una riga CSV per evento (tempo_ns,data,evento,slot,conn,arg1..arg4)
+       invece del formato leggibile "data slot conn EVENTO nome=valore ...".
+     - file_eventi: uno o piu' file prodotti dal server (paroliere.events e le sue
+       rotazioni), decodificati nell'ordine dato: per la cronologia completa passare
+       prima le rotazioni piu' vecchie (paroliere.events.3 ... paroliere.events).
+
+    si assume che:
+        - i file siano stati scritti su una macchina con lo stesso byte order
+          (l'intestazione del file permette di riconoscere il caso contrario)
+*/
+
+#define _GNU_SOURCE
+
+#include "server/eventlog.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+// nome dell'evento e degli argomenti, indicizzati per EVENT_*
+static const struct
+{
+    const char *name;
+    const char *args[EVENT_MAX_ARGS];
+} event_info[] = {
+    [EVENT_LOGIN] = {"LOGIN", {"username"}},
+    [EVENT_DISCONNECT] = {"DISCONNESSIONE", {"punti"}},
+    [EVENT_WORD] = {"PAROLA", {"parola", "esito"}},
+    [EVENT_GAME_START] = {"INIZIO_PARTITA", {"durata", "punteggio_max"}},
+    [EVENT_GAME_END] = {"FINE_PARTITA", {"giocatori"}},
+};
+
+#define EVENT_INFO_COUNT (int)(sizeof(event_info) / sizeof(event_info[0]))
+
+// argomento decodificato di un record
+typedef struct
+{
+    char type;
+    int32_t value;
+    char text[EVENT_STR_MAX + 1];
+} event_arg;
+
+// stampa s come campo CSV (tra virgolette, con le virgolette raddoppiate)
+static void print_csv_string(const char *s)
+{
+    putchar('"');
+    for (; *s; s++)
+    {
+        if (*s == '"')
+            putchar('"');
+        putchar(*s);
+    }
+    putchar('"');
+}
+
+static void print_event(const event_header *h, const event_arg *args, bool csv)
+{
+    time_t sec = (time_t)(h->time_ns / 1000000000);
+    long nsec = (long)(h->time_ns % 1000000000);
+    struct tm tm;
+    char timestr[64];
+    localtime_r(&sec, &tm);
+    strftime(timestr, sizeof(timestr), "%Y-%m-%d %H:%M:%S", &tm);
+
+    const char *name = h->event < EVENT_INFO_COUNT && event_info[h->event].name ? event_info[h->event].name : NULL;
+    char unknown[16];
+    if (!name)
+    {
+        snprintf(unknown, sizeof(unknown), "EVENTO_%d", h->event);
+        name = unknown;
+    }
+
+    if (csv)
+    {
+        printf("%lld,%s.%09ld,%s,", (long long)h->time_ns, timestr, nsec, name);
+        if (h->slot == EVENT_NO_SLOT)
+            printf(",");
+        else
+            printf("%u,%u", h->slot, h->conn);
+        for (int i = 0; i < EVENT_MAX_ARGS; i++)
+        {
+            putchar(',');
+            if (i >= h->argc)
+                continue;
+            if (args[i].type == EVENT_ARG_STR)
+                print_csv_string(args[i].text);
+            else
+                printf("%d", args[i].value);
+        }
+        putchar('\n');
+        return;
+    }
+
+    printf("[%s.%09ld] ", timestr, nsec);
+    if (h->slot == EVENT_NO_SLOT)
+        printf("%-20s", "-");
+    else
+        printf("slot %-4u conn %-6u ", h->slot, h->conn);
+    printf(" %s", name);
+    for (int i = 0; i < h->argc; i++)
+    {
+        const char *arg = h->event < EVENT_INFO_COUNT && event_info[h->event].args[i] ? event_info[h->event].args[i] : "arg";
+        if (args[i].type == EVENT_ARG_STR)
+            printf(" %s=%s", arg, args[i].text);
+        else
+            printf(" %s=%d", arg, args[i].value);
+    }
+    putchar('\n');
+}
+
+/*
+    dump_file:
+        decodifica e stampa tutti gli eventi del file 'path'.
+        restituisce 0 se il file e' stato letto fino in fondo, -1 altrimenti
+*/
+static int dump_file(const char *path, bool csv)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+    {
+        perror(path);
+        return -1;
+    }
+
+    event_file_header fh;
+    if (fread(&fh, sizeof(fh), 1, fp) != 1 || memcmp(fh.magic, EVENT_MAGIC, sizeof(fh.magic)) != 0)
+    {
+        fprintf(stderr, "%s: non e' un log degli eventi\n", path);
+        fclose(fp);
+        return -1;
+    }
+    if (fh.byte_order != EVENT_BYTE_ORDER || fh.header_size != sizeof(event_header))
+    {
+        fprintf(stderr, "%s: log scritto su una macchina con formato diverso\n", path);
+        fclose(fp);
+        return -1;
+    }
+
+    int ret = 0;
+    event_header h;
+    event_arg args[EVENT_MAX_ARGS];
+    size_t n;
+    while ((n = fread(&h, 1, sizeof(h), fp)) > 0)
+    {
+        bool ok = n == sizeof(h) && h.argc <= EVENT_MAX_ARGS;
+        for (int i = 0; ok && i < h.argc; i++)
+        {
+            unsigned char type_len[2];
+            ok = fread(type_len, 2, 1, fp) == 1;
+            if (!ok)
+                break;
+            args[i].type = (char)type_len[0];
+            if (args[i].type == EVENT_ARG_INT && type_len[1] == sizeof(int32_t))
+            {
+                ok = fread(&args[i].value, sizeof(int32_t), 1, fp) == 1;
+            }
+            else if (args[i].type == EVENT_ARG_STR)
+            {
+                ok = fread(args[i].text, 1, type_len[1], fp) == type_len[1];
+                args[i].text[type_len[1]] = '\0';
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+        if (!ok)
+        {
+            // record troncato (server terminato durante la scrittura) o file danneggiato
+            fprintf(stderr, "%s: record non valido a offset %ld, lettura interrotta\n", path, ftell(fp));
+            ret = -1;
+            break;
+        }
+        print_event(&h, args, csv);
+    }
+    fclose(fp);
+    return ret;
+}
+
+int main(int argc, char *argv[])
+{
+    bool csv = false;
+    int first = 1;
+    if (argc > 1 && strcmp(argv[1], "--csv") == 0)
+    {
+        csv = true;
+        first = 2;
+    }
+    if (first >= argc)
+    {
+        fprintf(stderr, "Uso corretto: %s [--csv] file_eventi...\n", argv[0]);
+        return 1;
+    }
+
+    if (csv)
+        printf("tempo_ns,data,evento,slot,conn,arg1,arg2,arg3,arg4\n");
+    int ret = 0;
+    for (int i = first; i < argc; i++)
+    {
+        if (dump_file(argv[i], csv) < 0)
+            ret = 1;
+    }
+    return ret;
+}